@@ -13,24 +13,41 @@
   or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
 */
 #include "asciitomorse.h"
+#include "edgelog.h"
+#include "keyer.h"
+#include "keyinput.h"
+#include "macro.h"
 #include "morsetoascii.h"
+#include "outputqueue.h"
+#include "sidetone.h"
 #include "trace.h"
 
-// Typedefs
-enum KeyState { KEY_DOWN, KEY_UP };
-
 // Constants
-const int morseKeyPin = 2;
+const int morseKeyPin = 2;     // Straight key, or dit paddle.
 const int morseKeyLED = 3;
+const int morseDahPin = 4;     // Dah paddle.
+const int macroButtonPin = 5;  // Plays macro slot 0, or stops playback.
 const int morseOutputPin = 13;
+const unsigned int sidetoneFrequency = 600; // Hz, on Sidetone::OUTPUT_PIN.
 
-// Common storage.
-unsigned long keyDuration = 0;
-KeyState      keyState = KEY_UP;
+// Key input. Set useKeyer for iambic paddles on morseKeyPin and morseDahPin, instead of a straight key.
+const bool              useKeyer = false;
+const IambicKeyer::Mode keyerMode = IambicKeyer::IAMBIC_B;
+const unsigned long     keyerDotDuration = Morse::DOT_DURATION; // ms
 
 // Things that actually do stuff.
 AsciiToMorse atm;
 MorseToAscii mta;
+KeyInput     keyInput;
+IambicKeyer  keyer;
+MacroStore   macros;
+MacroPlayer  player( macros );
+MacroCommand macroCommand( macros, player );
+KeyInput     macroButton;
+
+#if RECORD_EDGES
+EdgeLog      edgeLog;
+#endif
 
 // setup()
 //  
@@ -43,6 +60,24 @@ void setup()
   pinMode( morseOutputPin, OUTPUT );
   atm.setOutputLine( morseOutputPin );
   
+  // Macros key the same output, when there's no text to send.
+  player.setOutputLine( morseOutputPin );
+  pinMode( macroButtonPin, INPUT );
+  digitalWrite( macroButtonPin, HIGH );
+  
+  // Start a beacon, if one has been set up.
+  for ( unsigned int slot = 0; slot < MacroStore::SLOT_COUNT; ++slot )
+  {
+    if ( macros.repeat( slot ) != 0 )
+    {
+      player.play( slot, millis() );
+      break;
+    }
+  }
+  
+  // Set up the sidetone monitor.
+  Sidetone::begin( sidetoneFrequency );
+  
   // Set up Morse key feedback LED.
   pinMode( morseKeyLED, OUTPUT );
   digitalWrite( morseKeyLED, LOW );
@@ -50,6 +85,16 @@ void setup()
   // Set up Morse key input, pulled up.
   pinMode( morseKeyPin, INPUT );
   digitalWrite( morseKeyPin, HIGH );
+  
+  if ( useKeyer )
+  {
+    // Set up the dah paddle, pulled up. Decode at the keyer's speed.
+    pinMode( morseDahPin, INPUT );
+    digitalWrite( morseDahPin, HIGH );
+    keyer.setMode( keyerMode );
+    keyer.setDotDuration( keyerDotDuration );
+    mta.setDotDuration( keyerDotDuration );
+  }
 }
 
 // loop()
@@ -59,92 +104,110 @@ void loop()
 {  
   // Update timing info.
   atm.timestamp( millis() );
-  if ( keyState == KEY_UP )
+  if ( useKeyer ? !keyer.keyed() : keyInput.state() == KeyInput::KEY_UP )
   {
     mta.timestamp( millis() );
   }
   
+  if ( atm.idle() )
+  {
+    player.timestamp( millis() );
+  }
+  macros.service();
+  
   // Look for ASCII input on the serial port.
   if ( Serial.available() > 0 )
   {
-    #if TRACE
     char c = Serial.read();
-    Serial.print( "( loop() ) Converting to Morse code: " );
-    Serial.println( c );
-    atm.addChar( c );
-    #else
-    atm.addChar( Serial.read() );
-    #endif
+    if ( !macroCommand.addChar( c, millis() ) )
+    {
+      // Text takes over from macros.
+      player.stop();
+      #if TRACE
+      Serial.print( "( loop() ) Converting to Morse code: " );
+      Serial.println( c );
+      #endif
+      atm.addChar( c );
+    }
+  }
+  
+  // Look for the macro button.
+  if ( macroButton.sample( millis(), digitalRead( macroButtonPin ) ) )
+  {
+    if ( player.playing() )
+    {
+      player.stop();
+    }
+    else
+    {
+      player.play( 0, millis() );
+    }
   }
   
   // Look for Morse keypress.
-  if ( sampleInput() )
+  if ( useKeyer )
+  {
+    sampleKeyer();
+  }
+  else if ( sampleInput() )
   {
     #if TRACE
     Serial.print( "( loop() ) Key duration: " );
-    Serial.println( keyDuration );
+    Serial.println( keyInput.keyDuration() );
     #endif
         
     // DOT or DASH?
-    if ( keyDuration >= Morse::DOT_DURATION && keyDuration < Morse::DASH_DURATION )
+    // Decode at the sender's speed, not the one the sketch sends at.
+    mta.setDotDuration( keyInput.dotEstimate() );
+    const Morse::MorseCodeElement key = Morse::classifyMark( keyInput.keyDuration(), mta.dotDuration() );
+    if ( key != Morse::SPACE )
     {
-      // DOT.
       #if TRACE
-      Serial.println( "( loop() ) DOT keyed." );
+      Serial.println( key == Morse::DOT ? "( loop() ) DOT keyed." : "( loop() ) DASH keyed" );
       #endif
-      mta.keypress( Morse::DOT );
-    }
-    else if ( keyDuration >= Morse::DASH_DURATION )
-    {
-      // DASH.
-      #if TRACE
-      Serial.println( "( loop() ) DASH keyed" );
-      #endif
-      mta.keypress( Morse::DASH );
+      mta.keypress( key, millis() );
     }
     // else it's noise. Ignore it.
   }
+  
+  // Sound whichever is keying: the Morse output, or the local key.
+  Sidetone::key( atm.keyed() || player.keyed() || ( useKeyer ? keyer.keyed() : keyInput.state() == KeyInput::KEY_DOWN ) );
+  
+  // Lowest priority: hand the serial port whatever it can take without waiting.
+  serialOutput.drain();
 }
 
 // sampleInput()
 //
+// Reads the Morse key, and mirrors it on the feedback LED. Returns true when a debounced keypress has
+// ended.
 bool sampleInput()
 { 
-  const unsigned long debounceThreshold = 50; // ms
-  
-  static int previousLevel = HIGH;
-  static unsigned long edgeTime = 0;
-  static unsigned long keyDownTime = 0;
-  
-  bool keyAvailable = false;
-  unsigned long now = millis();
-  int level = digitalRead( morseKeyPin );
+  const int level = digitalRead( morseKeyPin );
   digitalWrite( morseKeyLED, level == HIGH ? LOW : HIGH );
   
-  if ( level != previousLevel )
-  {
-    edgeTime = now;
-  }
+  #if RECORD_EDGES
+  edgeLog.sample( micros(), level );
+  #endif
   
-  if ( now - edgeTime > debounceThreshold )
+  return keyInput.sample( millis(), level );
+}
+
+// sampleKeyer()
+//
+// Runs the iambic keyer on the paddles, and mirrors its output on the feedback LED. Its elements are
+// timed exactly, so they go straight to the decoder.
+void sampleKeyer()
+{
+  const unsigned long now = millis();
+  
+  if ( keyer.sample( now, digitalRead( morseKeyPin ), digitalRead( morseDahPin ) ) )
   {
-    // Switch debounced
-    if ( level == LOW and keyState == KEY_UP )
-    {
-      // Key pressed.
-      keyDownTime = now;
-      keyState = KEY_DOWN;
-    }
-    else if ( level == HIGH and keyState == KEY_DOWN )
-    {
-      // Key released.
-      keyDuration = now - keyDownTime;
-      keyAvailable = true;
-      keyState = KEY_UP;
-    }
+    #if TRACE
+    Serial.println( keyer.element() == Morse::DOT ? "( loop() ) DOT keyed." : "( loop() ) DASH keyed" );
+    #endif
+    mta.keypress( keyer.element(), now );
   }
   
-  previousLevel = level;
-  return keyAvailable;
+  digitalWrite( morseKeyLED, keyer.keyed() ? HIGH : LOW );
 }
-
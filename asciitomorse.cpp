@@ -12,6 +12,7 @@
 */
 #include <WProgram.h>
 #include "asciitomorse.h"
+#include "outputqueue.h"
 #include "trace.h"
 
 AsciiToMorse::AsciiToMorse() :
@@ -20,7 +21,8 @@ AsciiToMorse::AsciiToMorse() :
   codewordReadPoint( 0 ),
   queueInsertPoint( 0 ),
   queueExtractPoint( 0 ),
-  outputLine( 13 )
+  outputLine( 13 ),
+  outputRaised( false )
 {
   initializeCodeword();
   
@@ -43,7 +45,7 @@ void AsciiToMorse::addChar( const char character )
       addCharKeying( character );
       break;
     default:
-      Serial.println( "\n\n( ATM::addChar() ) ERROR: Unknown state." );
+      serialOutput.println( "\n\n( ATM::addChar() ) ERROR: Unknown state." );
       break;
   }
 }
@@ -92,18 +94,29 @@ void AsciiToMorse::timestamp( const unsigned long & now )
         timestampLetterSpace( now );
         break;
       default:
-        Serial.println( "\n\nERROR ( ATM::timestamp() ): Unknown state." );
+        serialOutput.println( "\n\nERROR ( ATM::timestamp() ): Unknown state." );
         break;
     }
   }
 }
 
+bool AsciiToMorse::keyed() const
+{
+  return outputRaised;
+}
+
+bool AsciiToMorse::idle() const
+{
+  return state == IDLE;
+}
+
 void AsciiToMorse::timestampKeying( const unsigned long & now )
 {
   #if TRACE
   Serial.println( "( ATM::timestampKeying() ) outputLine -> LOW." );
   #endif
   digitalWrite( outputLine, LOW );
+  outputRaised = false;
   eventTimestamp = now + Morse::KEY_SPACE_DURATION;
   
   #if TRACE_STATE
@@ -150,7 +163,7 @@ void AsciiToMorse::timestampKeySpace( const unsigned long & now )
       state = KEYING;
       break;
     default:
-      Serial.println( "\n\n( ATM::timestampKeySpace() ) ERROR: Unknown Morse key type in codeword." );
+      serialOutput.println( "\n\n( ATM::timestampKeySpace() ) ERROR: Unknown Morse key type in codeword." );
       break;
     }
   }
@@ -208,6 +221,7 @@ void AsciiToMorse::outputKey( const unsigned long keyDuration )
   #endif
   // Raise the output line.
   digitalWrite( outputLine, HIGH );
+  outputRaised = true;
   // Set the timestamp for when to handle the next event.
   eventTimestamp = millis() + keyDuration;
 }
@@ -264,8 +278,9 @@ void AsciiToMorse::processCharacter( const char character )
       #endif
       break;
     default:
-      Serial.print( "\n\n( ATM::processCharacter() ) ERROR: Unknown Morse key type in codeword: " );
-      Serial.println( *codeword, HEX );
+      serialOutput.print( "\n\n( ATM::processCharacter() ) ERROR: Unknown Morse key type in codeword: " );
+      serialOutput.print( static_cast< unsigned long >( *codeword ), HEX );
+      serialOutput.println();
       break;
   }
 }
@@ -283,6 +298,7 @@ void AsciiToMorse::processSpace()
   codewordReadPoint = 0;
   
   digitalWrite( outputLine, LOW );
+  outputRaised = false;
   eventTimestamp = millis() + Morse::WORD_SPACE_DURATION - Morse::KEY_SPACE_DURATION - Morse::LETTER_SPACE_DURATION;
   
   #if TRACE_STATE
@@ -39,6 +39,16 @@ class AsciiToMorse
   // function is executed, with a call to millis() passed in.
   void timestamp( const unsigned long & now );
   
+  // keyed()
+  // Returns:
+  //   true while the output line is raised for a DOT or DASH.
+  bool keyed() const;
+  
+  // idle()
+  // Returns:
+  //   true when there is nothing being sent, or waiting to be.
+  bool idle() const;
+  
   private:
   // State machine:
   // NOTE: Doesn't show handling of ASCII SPACE when converting char to Morse code. A SPACE is represented
@@ -81,6 +91,7 @@ class AsciiToMorse
   unsigned int              queueInsertPoint;
   unsigned int              queueExtractPoint;
   int                       outputLine;
+  bool                      outputRaised;
   
   // addCharIdle()
   // Arguments:
@@ -0,0 +1,108 @@
+/*
+  edgelog.cpp
+
+  Compact log of raw key edges, for recording operating sessions on the board and replaying them
+  through the same code off the board.
+    
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/ 
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <WProgram.h>
+#include "edgelog.h"
+#include "outputqueue.h"
+
+//
+// EdgeLog
+//
+
+EdgeLog::EdgeLog() :
+  previousLevel( HIGH ),
+  previousTime( 0 )
+{
+}
+
+void EdgeLog::sample( const unsigned long & now, const int level )
+{
+  if ( level == previousLevel )
+  {
+    return;
+  }
+  
+  // Queue the record as a string, so it goes in whole or not at all. Record bytes are never zero.
+  char record[ RECORD_LENGTH + 1 ];
+  const unsigned int length = encode( now - previousTime, level, reinterpret_cast< unsigned char * >( record ) );
+  record[ length ] = 0;
+  serialOutput.print( record );
+  
+  previousLevel = level;
+  previousTime = now;
+}
+
+unsigned int EdgeLog::encode( const unsigned long delta, const int level, unsigned char * const record )
+{
+  unsigned long value = ( ( delta < MAX_DELTA ? delta : MAX_DELTA ) << 1 ) | ( level == HIGH ? 1 : 0 );
+  unsigned int length = 0;
+  
+  while ( value > DATA_MASK )
+  {
+    record[ length++ ] = static_cast< unsigned char >( RECORD_FLAG | MORE_FLAG | ( value & DATA_MASK ) );
+    value >>= DATA_BITS;
+  }
+  record[ length++ ] = static_cast< unsigned char >( RECORD_FLAG | value );
+  
+  return length;
+}
+
+//
+// EdgeLogParser
+//
+
+EdgeLogParser::EdgeLogParser() :
+  value( 0 ),
+  shift( 0 ),
+  edgeDelta( 0 ),
+  edgeLevel( HIGH )
+{
+}
+
+bool EdgeLogParser::parse( const unsigned char byte )
+{
+  if ( ( byte & EdgeLog::RECORD_FLAG ) == 0 )
+  {
+    // Text.
+    return false;
+  }
+  
+  if ( shift < 8 * sizeof( value ) )
+  {
+    value |= static_cast< unsigned long >( byte & EdgeLog::DATA_MASK ) << shift;
+  }
+  shift += EdgeLog::DATA_BITS;
+  
+  if ( ( byte & EdgeLog::MORE_FLAG ) != 0 )
+  {
+    // Record continues.
+    return false;
+  }
+  
+  edgeDelta = value >> 1;
+  edgeLevel = ( value & 1 ) != 0 ? HIGH : LOW;
+  value = 0;
+  shift = 0;
+  
+  return true;
+}
+
+unsigned long EdgeLogParser::delta() const
+{
+  return edgeDelta;
+}
+
+int EdgeLogParser::level() const
+{
+  return edgeLevel;
+}
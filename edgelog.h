@@ -0,0 +1,98 @@
+/*
+  edgelog.h
+
+  Compact log of raw key edges, for recording operating sessions on the board and replaying them
+  through the same code off the board.
+
+  Each edge is one record: the time since the previous edge in microseconds, shifted left one bit, with
+  the new level of the key pin in the low bit. The value is split into 6-bit groups, lowest first, one
+  group to a byte. Every record byte has its top bit set, and every one but the last has bit 6 set too.
+  Text the sketch prints is 7-bit ASCII, so records can share the serial port with it, and a host can
+  pick them back out of a capture of the port. Carrying the level means a lost record costs its time,
+  not the sense of every edge after it.
+    
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/ 
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#ifndef EDGELOG_H
+#define EDGELOG_H
+
+class EdgeLog
+{
+  public:
+  //
+  // Constants
+  //
+  
+  static const unsigned char RECORD_FLAG = 0x80;
+  static const unsigned char MORE_FLAG = 0x40;
+  static const unsigned char DATA_MASK = 0x3F;
+  static const unsigned int  DATA_BITS = 6;
+  
+  // Longest time between edges that can be logged, in microseconds. About 35 minutes.
+  static const unsigned long MAX_DELTA = 0x7FFFFFFFUL;
+  
+  // Longest record: 32 bits in 6-bit groups.
+  static const unsigned int RECORD_LENGTH = 6;
+  
+  // Constructor
+  EdgeLog();
+  
+  // sample()
+  // Arguments:
+  //   now - Time in microseconds since startup.
+  //   level - Level read from the key pin.
+  // Feed the edge log a sample of the key pin. When the level has changed since the last sample, queues
+  // a record of the edge for the serial port. A record that doesn't fit in the queue is dropped whole.
+  void sample( const unsigned long & now, const int level );
+  
+  // encode()
+  // Arguments:
+  //   delta - Microseconds since the previous edge.
+  //   level - Level of the key pin after the edge.
+  //   record - Storage for at least RECORD_LENGTH bytes.
+  // Returns:
+  //   Number of bytes in the record.
+  static unsigned int encode( const unsigned long delta, const int level, unsigned char * const record );
+  
+  private:
+  int           previousLevel;
+  unsigned long previousTime;
+};
+
+class EdgeLogParser
+{
+  public:
+  // Constructor
+  EdgeLogParser();
+  
+  // parse()
+  // Arguments:
+  //   byte - Next byte of a capture of the serial port.
+  // Returns:
+  //   true when byte completes an edge record, and delta() and level() describe it. Bytes without the
+  //   top bit set are text, not records, and leave any record in progress alone.
+  bool parse( const unsigned char byte );
+  
+  // delta()
+  // Returns:
+  //   Microseconds between the last edge parsed and the one before it.
+  unsigned long delta() const;
+  
+  // level()
+  // Returns:
+  //   Level of the key pin after the last edge parsed.
+  int level() const;
+  
+  private:
+  unsigned long value;    // Record in progress.
+  unsigned int  shift;    // Bit position of the next group.
+  unsigned long edgeDelta;
+  int           edgeLevel;
+};
+
+#endif
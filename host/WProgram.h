@@ -0,0 +1,92 @@
+/*
+  WProgram.h
+
+  Host stand-in for the parts of the Arduino core the sketch uses, so its classes can be built and run
+  off the board. Time is virtual: host programs set it with hostSetTime(), and millis() and micros()
+  return it until it is set again. Pin levels and the clock are per thread, so each thread can run its
+  own copy of the sketch's classes. Serial output goes to stderr.
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#ifndef WPROGRAM_H
+#define WPROGRAM_H
+
+#include <stdint.h>
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT  0x0
+#define OUTPUT 0x1
+
+#define DEC 10
+#define HEX 16
+
+//
+// Arduino core
+//
+
+unsigned long millis();
+unsigned long micros();
+
+void pinMode( const uint8_t pin, const uint8_t mode );
+void digitalWrite( const uint8_t pin, const uint8_t level );
+int digitalRead( const uint8_t pin );
+
+class HardwareSerial
+{
+  public:
+  void begin( const long baud );
+  int available();
+  int read();
+  void write( const uint8_t character );
+
+  void print( const char * const string );
+  void print( const char character );
+  void print( const int value, const int base = DEC );
+  void print( const unsigned int value, const int base = DEC );
+  void print( const long value, const int base = DEC );
+  void print( const unsigned long value, const int base = DEC );
+
+  void println();
+  void println( const char * const string );
+  void println( const char character );
+  void println( const int value, const int base = DEC );
+  void println( const unsigned int value, const int base = DEC );
+  void println( const long value, const int base = DEC );
+  void println( const unsigned long value, const int base = DEC );
+};
+
+extern HardwareSerial Serial;
+
+//
+// Host controls
+//
+
+// Called whenever the sketch writes a pin.
+typedef void ( * HostPinHook )( const uint8_t pin, const uint8_t level );
+
+// hostSetTime()
+// Arguments:
+//   now - Time in microseconds since startup.
+// Sets the time returned by millis() and micros().
+void hostSetTime( const unsigned long now );
+
+// hostSetPin()
+// Arguments:
+//   pin - Pin number.
+//   level - HIGH or LOW.
+// Sets the level digitalRead() returns for a pin.
+void hostSetPin( const uint8_t pin, const int level );
+
+// hostSetPinHook()
+// Arguments:
+//   hook - Function to call on digitalWrite(), or 0 for none.
+void hostSetPinHook( const HostPinHook hook );
+
+#endif
@@ -0,0 +1,184 @@
+/*
+  arduino.cpp
+
+  Host stand-in for the parts of the Arduino core the sketch uses.
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <cstdio>
+#include "WProgram.h"
+
+HardwareSerial Serial;
+
+// Enough pins for an ATmega328 board.
+static const unsigned int pinCount = 20;
+
+static thread_local unsigned long hostTime = 0;
+static thread_local int           pinLevels[ pinCount ] = { 0 };
+static thread_local HostPinHook   pinHook = 0;
+
+//
+// Arduino core
+//
+
+unsigned long millis()
+{
+  return hostTime / 1000;
+}
+
+unsigned long micros()
+{
+  return hostTime;
+}
+
+void pinMode( const uint8_t pin, const uint8_t mode )
+{
+  // Nothing to configure.
+  ( void )pin;
+  ( void )mode;
+}
+
+void digitalWrite( const uint8_t pin, const uint8_t level )
+{
+  if ( pin < pinCount )
+  {
+    pinLevels[ pin ] = level;
+  }
+
+  if ( pinHook != 0 )
+  {
+    pinHook( pin, level );
+  }
+}
+
+int digitalRead( const uint8_t pin )
+{
+  return pin < pinCount ? pinLevels[ pin ] : LOW;
+}
+
+void HardwareSerial::begin( const long baud )
+{
+  ( void )baud;
+}
+
+int HardwareSerial::available()
+{
+  // Host programs feed the sketch's classes directly.
+  return 0;
+}
+
+int HardwareSerial::read()
+{
+  return -1;
+}
+
+void HardwareSerial::write( const uint8_t character )
+{
+  std::fputc( character, stderr );
+}
+
+void HardwareSerial::print( const char * const string )
+{
+  std::fputs( string, stderr );
+}
+
+void HardwareSerial::print( const char character )
+{
+  std::fputc( character, stderr );
+}
+
+void HardwareSerial::print( const int value, const int base )
+{
+  print( static_cast< long >( value ), base );
+}
+
+void HardwareSerial::print( const unsigned int value, const int base )
+{
+  print( static_cast< unsigned long >( value ), base );
+}
+
+void HardwareSerial::print( const long value, const int base )
+{
+  if ( base == DEC && value < 0 )
+  {
+    print( '-' );
+    print( static_cast< unsigned long >( -value ), base );
+  }
+  else
+  {
+    print( static_cast< unsigned long >( value ), base );
+  }
+}
+
+void HardwareSerial::print( const unsigned long value, const int base )
+{
+  std::fprintf( stderr, base == HEX ? "%lX" : "%lu", value );
+}
+
+void HardwareSerial::println()
+{
+  print( "\r\n" );
+}
+
+void HardwareSerial::println( const char * const string )
+{
+  print( string );
+  println();
+}
+
+void HardwareSerial::println( const char character )
+{
+  print( character );
+  println();
+}
+
+void HardwareSerial::println( const int value, const int base )
+{
+  print( value, base );
+  println();
+}
+
+void HardwareSerial::println( const unsigned int value, const int base )
+{
+  print( value, base );
+  println();
+}
+
+void HardwareSerial::println( const long value, const int base )
+{
+  print( value, base );
+  println();
+}
+
+void HardwareSerial::println( const unsigned long value, const int base )
+{
+  print( value, base );
+  println();
+}
+
+//
+// Host controls
+//
+
+void hostSetTime( const unsigned long now )
+{
+  hostTime = now;
+}
+
+void hostSetPin( const uint8_t pin, const int level )
+{
+  if ( pin < pinCount )
+  {
+    pinLevels[ pin ] = level;
+  }
+}
+
+void hostSetPinHook( const HostPinHook hook )
+{
+  pinHook = hook;
+}
@@ -0,0 +1,205 @@
+/*
+  audio.cpp
+
+  Keyed audio for host programs.
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <cmath>
+#include "audio.h"
+
+static const double pi = 3.14159265358979323846;
+
+// Envelope detector tuning. The envelope filter has to smooth out the tone's ripple while still
+// following element edges; peak and floor have to ride through fading without forgetting the tone
+// during a word space.
+static const double envelopeTimeConstant = 0.002;  // seconds
+static const double trackingTimeConstant = 2.0;    // seconds
+static const double keyOnThreshold = 0.5;          // Fraction of the way from floor to peak.
+static const double keyOffThreshold = 0.35;
+static const double minimumContrast = 200.0;       // Peak above floor needed to believe there's a tone.
+
+//
+// ToneRenderer
+//
+
+ToneRenderer::ToneRenderer( const unsigned int sampleRate, const double frequency, const double amplitude, const double ramp ) :
+  sampleRate( sampleRate ),
+  amplitude( amplitude * 32767.0 ),
+  phaseStep( 2.0 * pi * frequency / sampleRate ),
+  rampSamples( static_cast< unsigned int >( ramp * sampleRate / 1000.0 ) + 1 ),
+  time( 0 ),
+  sampleCount( 0 ),
+  toneStart( 0 ),
+  toneEnd( 0 ),
+  phase( 0.0 ),
+  keyDown( true )
+{
+}
+
+void ToneRenderer::add( const unsigned long duration, std::vector< unsigned char > & pcm )
+{
+  // Runs end on whole samples of the overall timeline, so rounding never accumulates.
+  time += duration;
+  const unsigned long long end = time * sampleRate / 1000;
+
+  if ( keyDown )
+  {
+    toneStart = sampleCount;
+    toneEnd = ~0ULL;
+  }
+  else
+  {
+    toneEnd = sampleCount;
+  }
+
+  for ( ; sampleCount < end; ++sampleCount )
+  {
+    // Raised cosine rise from key down, and fall from key up.
+    double gain = 1.0;
+    const unsigned long long rising = sampleCount - toneStart;
+    if ( rising < rampSamples )
+    {
+      gain = 0.5 - 0.5 * std::cos( pi * rising / rampSamples );
+    }
+    if ( sampleCount >= toneEnd )
+    {
+      const unsigned long long falling = sampleCount - toneEnd;
+      gain *= falling < rampSamples ? 0.5 + 0.5 * std::cos( pi * falling / rampSamples ) : 0.0;
+    }
+
+    int16_t sample = 0;
+    if ( gain > 0.0 )
+    {
+      sample = static_cast< int16_t >( std::lround( amplitude * gain * std::sin( phase ) ) );
+      phase += phaseStep;
+      if ( phase >= 2.0 * pi )
+      {
+        phase -= 2.0 * pi;
+      }
+    }
+
+    pcm.push_back( static_cast< unsigned char >( sample & 0xFF ) );
+    pcm.push_back( static_cast< unsigned char >( ( sample >> 8 ) & 0xFF ) );
+  }
+
+  keyDown = !keyDown;
+}
+
+//
+// EnvelopeDetector
+//
+
+EnvelopeDetector::EnvelopeDetector( const unsigned int sampleRate ) :
+  sampleRate( sampleRate ),
+  smoothing( 1.0 - std::exp( -1.0 / ( envelopeTimeConstant * sampleRate ) ) ),
+  decay( std::exp( -1.0 / ( trackingTimeConstant * sampleRate ) ) ),
+  level( 0.0 ),
+  peak( 0.0 ),
+  floor( 0.0 ),
+  keyed( false ),
+  started( false ),
+  sampleCount( 0 ),
+  edgeTime( 0 ),
+  heldByte( -1 )
+{
+}
+
+void EnvelopeDetector::add( const int16_t * const samples, const size_t count, std::vector< unsigned long > & runs )
+{
+  for ( size_t idx = 0; idx < count; ++idx, ++sampleCount )
+  {
+    level += smoothing * ( std::fabs( static_cast< double >( samples[ idx ] ) ) - level );
+
+    // Peak follows the tone up at once and forgets it slowly. Floor does the opposite with the noise.
+    peak = level > peak ? level : peak * decay;
+    floor = level < floor ? level : level + ( floor - level ) * decay;
+
+    const double contrast = peak - floor;
+    if ( contrast < minimumContrast )
+    {
+      if ( keyed )
+      {
+        edge( runs );
+      }
+      continue;
+    }
+
+    if ( !keyed && level > floor + keyOnThreshold * contrast )
+    {
+      edge( runs );
+    }
+    else if ( keyed && level < floor + keyOffThreshold * contrast )
+    {
+      edge( runs );
+    }
+  }
+}
+
+void EnvelopeDetector::addBytes( const unsigned char * const pcm, const size_t length, std::vector< unsigned long > & runs )
+{
+  size_t position = 0;
+  int16_t samples[ 1024 ];
+  size_t count = 0;
+
+  if ( heldByte >= 0 && length > 0 )
+  {
+    samples[ count++ ] = static_cast< int16_t >( heldByte | pcm[ 0 ] << 8 );
+    heldByte = -1;
+    position = 1;
+  }
+
+  for ( ; position + 1 < length; position += 2 )
+  {
+    samples[ count++ ] = static_cast< int16_t >( pcm[ position ] | pcm[ position + 1 ] << 8 );
+    if ( count == sizeof( samples ) / sizeof( samples[ 0 ] ) )
+    {
+      add( samples, count, runs );
+      count = 0;
+    }
+  }
+  add( samples, count, runs );
+
+  if ( position < length )
+  {
+    heldByte = pcm[ position ];
+  }
+}
+
+void EnvelopeDetector::finish( std::vector< unsigned long > & runs )
+{
+  if ( !started )
+  {
+    // Never heard a tone.
+    return;
+  }
+
+  if ( keyed )
+  {
+    // Release the key.
+    edge( runs );
+  }
+
+  // Runs always end with key up.
+  runs.push_back( static_cast< unsigned long >( sampleCount * 1000 / sampleRate - edgeTime ) );
+}
+
+void EnvelopeDetector::edge( std::vector< unsigned long > & runs )
+{
+  const unsigned long long now = sampleCount * 1000 / sampleRate;
+
+  // Leading silence isn't a run. Runs start with key down.
+  if ( started )
+  {
+    runs.push_back( static_cast< unsigned long >( now - edgeTime ) );
+  }
+
+  started = true;
+  edgeTime = now;
+  keyed = !keyed;
+}
@@ -0,0 +1,100 @@
+/*
+  audio.h
+
+  Keyed audio for host programs. ToneRenderer turns key down / key up runs into a shaped sine tone, and
+  EnvelopeDetector turns a recording of a keyed tone back into runs.
+
+  Audio is 16-bit signed little endian mono PCM.
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+class ToneRenderer
+{
+  public:
+  // Constructor
+  // Arguments:
+  //   sampleRate - samples per second.
+  //   frequency - tone frequency in Hz.
+  //   amplitude - peak level, 0 to 1.
+  //   ramp - rise and fall time of the tone, in milliseconds.
+  ToneRenderer( const unsigned int sampleRate, const double frequency, const double amplitude, const double ramp );
+
+  // add()
+  // Arguments:
+  //   duration - next run, in milliseconds. Runs alternate key down and key up, starting with key down.
+  //   pcm - where samples are appended.
+  // Each tone starts rising at key down and starts falling at key up, so the keyed length of the tone
+  // matches the run.
+  void add( const unsigned long duration, std::vector< unsigned char > & pcm );
+
+  private:
+  const unsigned int sampleRate;
+  const double       amplitude;
+  const double       phaseStep;      // Radians per sample.
+  const unsigned int rampSamples;
+  unsigned long long time;           // Milliseconds keyed so far.
+  unsigned long long sampleCount;    // Samples rendered so far.
+  unsigned long long toneStart;      // Sample the current or last tone started at.
+  unsigned long long toneEnd;        // Sample the last tone was released at, or ~0 while keyed.
+  double             phase;
+  bool               keyDown;        // Polarity of the next run.
+};
+
+class EnvelopeDetector
+{
+  public:
+  // Constructor
+  // Arguments:
+  //   sampleRate - samples per second.
+  EnvelopeDetector( const unsigned int sampleRate );
+
+  // add()
+  // Arguments:
+  //   samples - audio to detect.
+  //   count - number of samples.
+  //   runs - where finished runs are appended. Runs alternate key down and key up, starting with key down.
+  void add( const int16_t * const samples, const size_t count, std::vector< unsigned long > & runs );
+
+  // addBytes()
+  // Arguments:
+  //   pcm - little endian audio. An odd trailing byte is held until the next call.
+  //   length - number of bytes.
+  //   runs - where finished runs are appended.
+  void addBytes( const unsigned char * const pcm, const size_t length, std::vector< unsigned long > & runs );
+
+  // finish()
+  // Arguments:
+  //   runs - where the run in progress is appended.
+  void finish( std::vector< unsigned long > & runs );
+
+  private:
+  const unsigned int sampleRate;
+  const double       smoothing;      // Envelope filter coefficient.
+  const double       decay;          // Peak and floor tracking coefficient.
+  double             level;          // Smoothed envelope.
+  double             peak;           // Recent tone level.
+  double             floor;          // Recent noise level.
+  bool               keyed;
+  bool               started;        // The first key down has been seen.
+  unsigned long long sampleCount;
+  unsigned long long edgeTime;       // Milliseconds at the last edge.
+  int                heldByte;       // Odd byte from the last addBytes(), or -1.
+
+  // edge()
+  // Records a key edge at the current sample.
+  void edge( std::vector< unsigned long > & runs );
+};
+
+#endif
@@ -0,0 +1,71 @@
+/*
+  check.h
+
+  Bare bones support for the host check programs, such as streamcheck. Each one is a plain executable:
+  it runs its checks, prints the ones that fail, and exits with 1 if any did. See README for how to
+  build and run them.
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <cstdarg>
+#include <cstdio>
+
+class Check
+{
+  public:
+  // Constructor
+  // Arguments:
+  //   name - program name, for the summary.
+  explicit Check( const char * const name ) :
+    name( name ),
+    count( 0 ),
+    failures( 0 )
+  {
+  }
+
+  // operator()
+  // Arguments:
+  //   passed - outcome of the check.
+  //   format, ... - printf() description of the check, printed if it failed.
+  // Returns:
+  //   passed.
+  bool operator()( const bool passed, const char * const format, ... )
+  {
+    ++count;
+    if ( !passed )
+    {
+      ++failures;
+      std::va_list arguments;
+      va_start( arguments, format );
+      std::fprintf( stderr, "%s: FAILED: ", name );
+      std::vfprintf( stderr, format, arguments );
+      std::fprintf( stderr, "\n" );
+      va_end( arguments );
+    }
+    return passed;
+  }
+
+  // finish()
+  // Returns:
+  //   The exit status for main(): 0 if every check passed.
+  int finish() const
+  {
+    std::printf( "%s: %lu checks, %lu failed\n", name, count, failures );
+    return failures == 0 ? 0 : 1;
+  }
+
+  private:
+  const char *  name;
+  unsigned long count;
+  unsigned long failures;
+};
+
+#endif
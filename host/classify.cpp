@@ -0,0 +1,281 @@
+/*
+  classify.cpp
+
+  Bulk classification of key timing.
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include "classify.h"
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <immintrin.h>
+#define CLASSIFY_X86 1
+#else
+#define CLASSIFY_X86 0
+#endif
+
+// Thresholds for every lane of a vector, in the order runs alternate.
+struct LaneThresholds
+{
+  uint16_t lower[ 16 ];   // Shortest DOT or letter gap.
+  uint16_t upper[ 16 ];   // Shortest DASH or word gap.
+  uint16_t base[ 16 ];    // Symbol for runs shorter than both.
+};
+
+static uint16_t scale( const unsigned long threshold, const unsigned long dotDuration, const unsigned long offset )
+{
+  const unsigned long scaled = threshold * dotDuration / Morse::DOT_DURATION + offset;
+  return static_cast< uint16_t >( scaled < 0xFFFF ? scaled : 0xFFFF );
+}
+
+static unsigned char classifyRun( const uint16_t duration, const bool keyDown,
+                                  const uint16_t * const markThresholds, const uint16_t * const gapThresholds )
+{
+  const uint16_t * const thresholds = keyDown ? markThresholds : gapThresholds;
+  return static_cast< unsigned char >( ( keyDown ? static_cast< unsigned char >( RunClassifier::NOISE ) : RunClassifier::GAP ) +
+                                       ( duration >= thresholds[ 0 ] ) + ( duration >= thresholds[ 1 ] ) );
+}
+
+static RunClassifier::Kernel detectKernel()
+{
+  #if CLASSIFY_X86
+  __builtin_cpu_init();
+  if ( __builtin_cpu_supports( "avx2" ) )
+  {
+    return RunClassifier::AVX2;
+  }
+  if ( __builtin_cpu_supports( "sse2" ) )
+  {
+    return RunClassifier::SSE2;
+  }
+  #endif
+  return RunClassifier::SCALAR;
+}
+
+static const RunClassifier::Kernel kernelInUse = detectKernel();
+
+// lanesFor()
+// Arguments:
+//   markThresholds, gapThresholds - From RunClassifier.
+//   firstKeyDown - The first lane holds a key down run.
+//   lanes - Storage for the thresholds of each lane.
+static void lanesFor( const uint16_t * const markThresholds, const uint16_t * const gapThresholds,
+                      const bool firstKeyDown, LaneThresholds & lanes )
+{
+  for ( unsigned int lane = 0; lane < 16; ++lane )
+  {
+    const bool keyDown = ( lane % 2 == 0 ) == firstKeyDown;
+    lanes.lower[ lane ] = keyDown ? markThresholds[ 0 ] : gapThresholds[ 0 ];
+    lanes.upper[ lane ] = keyDown ? markThresholds[ 1 ] : gapThresholds[ 1 ];
+    lanes.base[ lane ] = keyDown ? static_cast< unsigned char >( RunClassifier::NOISE ) : RunClassifier::GAP;
+  }
+}
+
+#if CLASSIFY_X86
+
+// Each lane counts the thresholds it reaches: subtracting with saturation leaves zero where the duration
+// is at least the threshold, and comparing that with zero gives -1. The kernels return how many runs
+// they classified, always an even number, and leave the rest to the caller.
+
+__attribute__(( target( "sse2" ) ))
+static size_t classifySse2( const uint16_t * const durations, const size_t count,
+                            const LaneThresholds & lanes, unsigned char * const symbols )
+{
+  const __m128i lower = _mm_loadu_si128( reinterpret_cast< const __m128i * >( lanes.lower ) );
+  const __m128i upper = _mm_loadu_si128( reinterpret_cast< const __m128i * >( lanes.upper ) );
+  const __m128i base = _mm_loadu_si128( reinterpret_cast< const __m128i * >( lanes.base ) );
+  const __m128i zero = _mm_setzero_si128();
+
+  size_t idx = 0;
+  for ( ; idx + 16 <= count; idx += 16 )
+  {
+    const __m128i low = _mm_loadu_si128( reinterpret_cast< const __m128i * >( durations + idx ) );
+    const __m128i high = _mm_loadu_si128( reinterpret_cast< const __m128i * >( durations + idx + 8 ) );
+
+    __m128i lowSymbols = _mm_sub_epi16( base, _mm_cmpeq_epi16( _mm_subs_epu16( lower, low ), zero ) );
+    lowSymbols = _mm_sub_epi16( lowSymbols, _mm_cmpeq_epi16( _mm_subs_epu16( upper, low ), zero ) );
+    __m128i highSymbols = _mm_sub_epi16( base, _mm_cmpeq_epi16( _mm_subs_epu16( lower, high ), zero ) );
+    highSymbols = _mm_sub_epi16( highSymbols, _mm_cmpeq_epi16( _mm_subs_epu16( upper, high ), zero ) );
+
+    _mm_storeu_si128( reinterpret_cast< __m128i * >( symbols + idx ), _mm_packus_epi16( lowSymbols, highSymbols ) );
+  }
+
+  return idx;
+}
+
+// narrowQuarterAvx2()
+// Arguments:
+//   runs - Four 64-bit runs.
+//   shuffle - Where in each half the low 16 bits of the half's two runs go. -1 clears a byte.
+// Returns:
+//   The runs saturated to 16 bits, in their place.
+__attribute__(( target( "avx2" ) ))
+static inline __m256i narrowQuarterAvx2( const uint64_t * const runs, const __m256i shuffle )
+{
+  const __m256i quad = _mm256_loadu_si256( reinterpret_cast< const __m256i * >( runs ) );
+  const __m256i fits = _mm256_cmpeq_epi64( _mm256_srli_epi64( quad, 16 ), _mm256_setzero_si256() );
+  const __m256i clamped = _mm256_blendv_epi8( _mm256_set1_epi64x( 0xFFFF ), quad, fits );
+  return _mm256_shuffle_epi8( clamped, shuffle );
+}
+
+// narrowAvx2()
+// Arguments:
+//   runs - Sixteen 64-bit runs.
+// Returns:
+//   The runs saturated to 16 bits, in order.
+__attribute__(( target( "avx2" ) ))
+static inline __m256i narrowAvx2( const uint64_t * const runs )
+{
+  // Each quarter of the runs lands in its own 32 bits of each half, so they can be ORed together.
+  const __m256i first = narrowQuarterAvx2( runs, _mm256_setr_epi8(
+    0, 1, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    0, 1, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 ) );
+  const __m256i second = narrowQuarterAvx2( runs + 4, _mm256_setr_epi8(
+    -1, -1, -1, -1, 0, 1, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, 0, 1, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1 ) );
+  const __m256i third = narrowQuarterAvx2( runs + 8, _mm256_setr_epi8(
+    -1, -1, -1, -1, -1, -1, -1, -1, 0, 1, 8, 9, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, 0, 1, 8, 9, -1, -1, -1, -1 ) );
+  const __m256i fourth = narrowQuarterAvx2( runs + 12, _mm256_setr_epi8(
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 1, 8, 9,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 1, 8, 9 ) );
+  const __m256i packed = _mm256_or_si256( _mm256_or_si256( first, second ), _mm256_or_si256( third, fourth ) );
+
+  // The low half holds runs 0-1, 4-5, 8-9 and 12-13, the high half 2-3, 6-7, 10-11 and 14-15.
+  return _mm256_permutevar8x32_epi32( packed, _mm256_setr_epi32( 0, 4, 1, 5, 2, 6, 3, 7 ) );
+}
+
+__attribute__(( target( "avx2" ) ))
+static size_t classifyAvx2( const uint64_t * const runs, const size_t count,
+                            const LaneThresholds & lanes, unsigned char * const symbols )
+{
+  const __m256i lower = _mm256_loadu_si256( reinterpret_cast< const __m256i * >( lanes.lower ) );
+  const __m256i upper = _mm256_loadu_si256( reinterpret_cast< const __m256i * >( lanes.upper ) );
+  const __m256i base = _mm256_loadu_si256( reinterpret_cast< const __m256i * >( lanes.base ) );
+  const __m256i zero = _mm256_setzero_si256();
+
+  size_t idx = 0;
+  for ( ; idx + 32 <= count; idx += 32 )
+  {
+    const __m256i low = narrowAvx2( runs + idx );
+    const __m256i high = narrowAvx2( runs + idx + 16 );
+
+    __m256i lowSymbols = _mm256_sub_epi16( base, _mm256_cmpeq_epi16( _mm256_subs_epu16( lower, low ), zero ) );
+    lowSymbols = _mm256_sub_epi16( lowSymbols, _mm256_cmpeq_epi16( _mm256_subs_epu16( upper, low ), zero ) );
+    __m256i highSymbols = _mm256_sub_epi16( base, _mm256_cmpeq_epi16( _mm256_subs_epu16( lower, high ), zero ) );
+    highSymbols = _mm256_sub_epi16( highSymbols, _mm256_cmpeq_epi16( _mm256_subs_epu16( upper, high ), zero ) );
+
+    // Packing works within 128-bit halves. Put the quarters back in order.
+    const __m256i packed = _mm256_packus_epi16( lowSymbols, highSymbols );
+    _mm256_storeu_si256( reinterpret_cast< __m256i * >( symbols + idx ), _mm256_permute4x64_epi64( packed, 0xD8 ) );
+  }
+
+  return idx;
+}
+
+#endif
+
+//
+// RunClassifier
+//
+
+RunClassifier::RunClassifier( const unsigned long dotDuration )
+{
+  setDotDuration( dotDuration );
+}
+
+void RunClassifier::setDotDuration( const unsigned long dotDuration )
+{
+  // Morse::classifyMark() keeps marks that reach its thresholds. MorseToAscii ends letters and words on
+  // gaps that pass its thresholds, hence the extra millisecond.
+  markThresholds[ 0 ] = scale( Morse::NOISE_THRESHOLD, dotDuration, 0 );
+  markThresholds[ 1 ] = scale( Morse::DASH_THRESHOLD, dotDuration, 0 );
+  gapThresholds[ 0 ] = scale( Morse::LETTER_SPACE_THRESHOLD, dotDuration, 1 );
+  gapThresholds[ 1 ] = scale( Morse::WORD_SPACE_THRESHOLD, dotDuration, 1 );
+}
+
+void RunClassifier::classify( const unsigned long * const runs, const size_t count, const bool firstKeyDown,
+                              unsigned char * const symbols ) const
+{
+  classify( runs, count, firstKeyDown, symbols, kernelInUse );
+}
+
+void RunClassifier::classify( const unsigned long * const runs, const size_t count, const bool firstKeyDown,
+                              unsigned char * const symbols, const Kernel kernel ) const
+{
+  const Kernel kernelUsed = kernel < kernelInUse ? kernel : kernelInUse;
+  size_t done = 0;
+
+  #if CLASSIFY_X86
+  LaneThresholds lanes;
+  lanesFor( markThresholds, gapThresholds, firstKeyDown, lanes );
+
+  if ( kernelUsed == AVX2 && sizeof( unsigned long ) == sizeof( uint64_t ) )
+  {
+    done = classifyAvx2( reinterpret_cast< const uint64_t * >( runs ), count, lanes, symbols );
+  }
+  else if ( kernelUsed != SCALAR )
+  {
+    uint16_t durations[ CHUNK_LENGTH ];
+
+    while ( count - done >= CHUNK_LENGTH )
+    {
+      for ( size_t idx = 0; idx < CHUNK_LENGTH; ++idx )
+      {
+        const unsigned long run = runs[ done + idx ];
+        durations[ idx ] = static_cast< uint16_t >( run < 0xFFFF ? run : 0xFFFF );
+      }
+
+      const size_t classified = classifySse2( durations, CHUNK_LENGTH, lanes, symbols + done );
+      classifyScalar( runs + done + classified, CHUNK_LENGTH - classified,
+                      ( classified % 2 == 0 ) == firstKeyDown, symbols + done + classified );
+      done += CHUNK_LENGTH;
+    }
+  }
+  #endif
+
+  // Whatever is left doesn't fill a vector, or a chunk. The kernels stop on an even run, so the
+  // polarity holds.
+  classifyScalar( runs + done, count - done, firstKeyDown, symbols + done );
+}
+
+void RunClassifier::classifyScalar( const unsigned long * const runs, const size_t count, const bool firstKeyDown,
+                                    unsigned char * const symbols ) const
+{
+  bool keyDown = firstKeyDown;
+
+  for ( size_t idx = 0; idx < count; ++idx )
+  {
+    const uint16_t duration = static_cast< uint16_t >( runs[ idx ] < 0xFFFF ? runs[ idx ] : 0xFFFF );
+    symbols[ idx ] = classifyRun( duration, keyDown, markThresholds, gapThresholds );
+    keyDown = !keyDown;
+  }
+}
+
+RunClassifier::Kernel RunClassifier::bestKernel()
+{
+  return kernelInUse;
+}
+
+const char * RunClassifier::kernel()
+{
+  return kernelName( kernelInUse );
+}
+
+const char * RunClassifier::kernelName( const Kernel kernel )
+{
+  switch ( kernel )
+  {
+    case AVX2:
+      return "avx2";
+    case SSE2:
+      return "sse2";
+    default:
+      return "scalar";
+  }
+}
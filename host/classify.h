@@ -0,0 +1,118 @@
+/*
+  classify.h
+
+  Bulk classification of key timing. RunClassifier sorts an array of key down / key up runs into DOTs,
+  DASHes, and the three kinds of gap, with the same thresholds the sketch uses one event at a time:
+  Morse::classifyMark() for key down, and MorseToAscii's letter and word space checks for key up. It is
+  the first stage of decoding timing in bulk.
+
+  Runs are classified as 16-bit durations, eight at a time with SSE2 or sixteen with AVX2, whichever
+  the CPU has. The AVX2 kernel also narrows the runs itself; SSE2 narrows them a chunk (CHUNK_LENGTH
+  runs) at a time first, so with SSE2 fewer runs than that always go one at a time. A duration that
+  doesn't fit in 16 bits classifies the same as 65535 ms, since every threshold is far shorter.
+  classifyScalar() is the reference the vector kernels have to agree with, and classifycheck checks
+  every kernel the CPU has against it.
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#ifndef CLASSIFY_H
+#define CLASSIFY_H
+
+#include <cstddef>
+#include <stdint.h>
+#include "morse.h"
+
+class RunClassifier
+{
+  public:
+  //
+  // Types
+  //
+
+  // One per run. Key down runs match Morse::MorseCodeElement, with Morse::SPACE for noise. Key up runs
+  // have GAP set.
+  enum Symbol
+  {
+    NOISE = Morse::SPACE,
+    DOT = Morse::DOT,
+    DASH = Morse::DASH,
+    ELEMENT_GAP = 4,
+    LETTER_GAP,
+    WORD_GAP
+  };
+
+  // Ways of classifying runs, slowest first.
+  enum Kernel { SCALAR, SSE2, AVX2 };
+
+  //
+  // Constants
+  //
+
+  static const unsigned char GAP = 4;
+  static const size_t CHUNK_LENGTH = 4096;  // Runs SSE2 narrows at a time. Even, so chunks start on key down.
+
+  // Constructor
+  // Arguments:
+  //   dotDuration - Length of a DOT in milliseconds. The thresholds scale with it, as in
+  //                 MorseToAscii::setDotDuration().
+  explicit RunClassifier( const unsigned long dotDuration = Morse::DOT_DURATION );
+
+  // setDotDuration()
+  // Arguments:
+  //   dotDuration - Length of a DOT in milliseconds.
+  // Rescales the thresholds, for a sender whose speed has been estimated.
+  void setDotDuration( const unsigned long dotDuration );
+
+  // classify()
+  // Arguments:
+  //   runs - Durations in milliseconds. Runs alternate key down and key up.
+  //   count - Number of runs.
+  //   firstKeyDown - runs[ 0 ] is a key down run.
+  //   symbols - Storage for count symbols.
+  // Classifies runs with the fastest kernel the CPU supports. With SSE2, fewer than CHUNK_LENGTH runs,
+  // and those after the last whole chunk, are classified one at a time. AVX2 leaves up to 31.
+  void classify( const unsigned long * const runs, const size_t count, const bool firstKeyDown,
+                 unsigned char * const symbols ) const;
+
+  // classify()
+  // Arguments:
+  //   runs, count, firstKeyDown, symbols - As above.
+  //   kernel - Kernel to use, for checking them all. The CPU's best stands in for one it doesn't have.
+  void classify( const unsigned long * const runs, const size_t count, const bool firstKeyDown,
+                 unsigned char * const symbols, const Kernel kernel ) const;
+
+  // classifyScalar()
+  // Same as classify(), one run at a time.
+  void classifyScalar( const unsigned long * const runs, const size_t count, const bool firstKeyDown,
+                       unsigned char * const symbols ) const;
+
+  // bestKernel()
+  // Returns:
+  //   The kernel classify() uses, the fastest the CPU supports.
+  static Kernel bestKernel();
+
+  // kernel()
+  // Returns:
+  //   Name of the kernel classify() uses: "avx2", "sse2", or "scalar".
+  static const char * kernel();
+
+  // kernelName()
+  // Arguments:
+  //   kernel - A kernel.
+  // Returns:
+  //   Its name: "avx2", "sse2", or "scalar".
+  static const char * kernelName( const Kernel kernel );
+
+  private:
+  // Shortest duration of each class. Key down runs of at least markThresholds[ 0 ] are DOTs, and of at
+  // least markThresholds[ 1 ] are DASHes. Key up runs likewise are letter and word gaps.
+  uint16_t markThresholds[ 2 ];
+  uint16_t gapThresholds[ 2 ];
+};
+
+#endif
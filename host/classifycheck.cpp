@@ -0,0 +1,174 @@
+/*
+  classifycheck.cpp
+
+  Checks bulk classification of key timing (classify.h) against the one run at a time code it stands
+  in for: RunClassifier::classify() against classifyScalar() and Morse::classifyMark(), and
+  RunDecoder::add() of an array of runs against adding them one at a time. The runs are random, near
+  every threshold and far past them, in counts that fill no whole vector or chunk as well as counts that
+  do. Every kernel this CPU has is checked, not just the one classify() picks.
+
+  Usage: classifycheck
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "check.h"
+#include "classify.h"
+#include "keying.h"
+
+// Constants
+
+// Durations the runs are drawn around, in DOTs at 100 ms: every element and gap the sketch sends.
+static const unsigned long lengths[] = { 1, 3, 5, 13 };
+
+// randomRuns()
+// Arguments:
+//   random - Source of randomness.
+//   count - Number of runs.
+//   dotDuration - Sender's DOT length, in milliseconds.
+// Returns:
+//   Runs near the elements and gaps at that speed, with noise, and some too long for 16 bits.
+static std::vector< unsigned long > randomRuns( std::mt19937 & random, const size_t count, const unsigned long dotDuration )
+{
+  std::vector< unsigned long > runs( count );
+  for ( size_t idx = 0; idx < count; ++idx )
+  {
+    const unsigned int pick = random() % 100;
+    if ( pick == 0 )
+    {
+      runs[ idx ] = 0xFFFF + random() % 3 - 1;
+    }
+    else if ( pick == 1 )
+    {
+      runs[ idx ] = random() % 2 == 0 ? ULONG_MAX : 0x10000 + random();
+    }
+    else if ( pick < 10 )
+    {
+      runs[ idx ] = random() % dotDuration;
+    }
+    else
+    {
+      // Anywhere from half to one and a half times the length, which covers every threshold.
+      const unsigned long length = lengths[ random() % ( sizeof( lengths ) / sizeof( lengths[ 0 ] ) ) ] * dotDuration;
+      runs[ idx ] = length / 2 + random() % ( length + 1 );
+    }
+  }
+  return runs;
+}
+
+static void checkClassify( Check & check )
+{
+  std::mt19937 random( 33 );
+  const unsigned long speeds[] = { 100, 60, 40, 150, 1 };
+  const size_t chunk = RunClassifier::CHUNK_LENGTH;
+  const size_t sizes[] = { 0, 1, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, chunk - 1, chunk, chunk + 1, chunk + 17,
+                           2 * chunk - 1, 2 * chunk, 2 * chunk + 1, 12345 };
+
+  for ( unsigned int speed = 0; speed < sizeof( speeds ) / sizeof( speeds[ 0 ] ); ++speed )
+  {
+    const RunClassifier classifier( speeds[ speed ] );
+    std::vector< size_t > counts( sizes, sizes + sizeof( sizes ) / sizeof( sizes[ 0 ] ) );
+    for ( unsigned int idx = 0; idx < 20; ++idx )
+    {
+      counts.push_back( random() % 3000 );
+    }
+
+    for ( size_t count = 0; count < counts.size(); ++count )
+    {
+      const std::vector< unsigned long > runs = randomRuns( random, counts[ count ], speeds[ speed ] );
+      for ( int firstKeyDown = 0; firstKeyDown < 2; ++firstKeyDown )
+      {
+        std::vector< unsigned char > scalar( runs.size() + 1, 0xAA );
+        classifier.classifyScalar( runs.data(), runs.size(), firstKeyDown != 0, scalar.data() );
+
+        for ( int kernel = RunClassifier::SCALAR; kernel <= RunClassifier::bestKernel(); ++kernel )
+        {
+          const char * const name = RunClassifier::kernelName( static_cast< RunClassifier::Kernel >( kernel ) );
+
+          // One spare symbol past the end, to catch a kernel writing beyond count.
+          std::vector< unsigned char > bulk( runs.size() + 1, 0xAA );
+          classifier.classify( runs.data(), runs.size(), firstKeyDown != 0, bulk.data(),
+                               static_cast< RunClassifier::Kernel >( kernel ) );
+
+          size_t mismatch = 0;
+          while ( mismatch < runs.size() && bulk[ mismatch ] == scalar[ mismatch ] )
+          {
+            ++mismatch;
+          }
+          check( mismatch == runs.size(), "%s, %lu runs at %lu ms dots, first key %s: run %lu, %lu ms, is %u, not %u", name,
+                 static_cast< unsigned long >( runs.size() ), speeds[ speed ], firstKeyDown != 0 ? "down" : "up",
+                 static_cast< unsigned long >( mismatch ), mismatch < runs.size() ? runs[ mismatch ] : 0,
+                 mismatch < runs.size() ? bulk[ mismatch ] : 0, mismatch < runs.size() ? scalar[ mismatch ] : 0 );
+          check( bulk[ runs.size() ] == 0xAA, "%s, %lu runs: nothing written past the end", name,
+                 static_cast< unsigned long >( runs.size() ) );
+        }
+
+        // Key down runs classify as the sketch classifies keypresses.
+        size_t disagree = 0;
+        for ( size_t run = firstKeyDown != 0 ? 0 : 1; run < runs.size(); run += 2 )
+        {
+          const unsigned long duration = runs[ run ] < 0xFFFF ? runs[ run ] : 0xFFFF;
+          disagree += scalar[ run ] != Morse::classifyMark( duration, speeds[ speed ] );
+        }
+        check( disagree == 0, "%lu key down runs at %lu ms dots disagree with Morse::classifyMark()",
+               static_cast< unsigned long >( disagree ), speeds[ speed ] );
+      }
+    }
+  }
+}
+
+static void checkDecoder( Check & check )
+{
+  std::mt19937 random( 330 );
+  RunDecoder bulk;
+  RunDecoder single;
+
+  for ( unsigned int trial = 0; trial < 200; ++trial )
+  {
+    const size_t count = trial < 4 ? trial : random() % 5000;
+    const std::vector< unsigned long > runs = randomRuns( random, count, Morse::DOT_DURATION );
+
+    bulk.reset();
+    single.reset();
+    std::string bulkText;
+    std::string singleText;
+
+    // In pieces of random size, so the bulk decoder picks up mid-character.
+    for ( size_t done = 0; done < runs.size(); )
+    {
+      const size_t piece = std::min< size_t >( runs.size() - done, 1 + random() % 700 );
+      bulk.add( runs.data() + done, piece, bulkText );
+      done += piece;
+    }
+    for ( size_t idx = 0; idx < runs.size(); ++idx )
+    {
+      single.add( runs[ idx ], singleText );
+    }
+    bulk.finish( bulkText );
+    single.finish( singleText );
+
+    check( bulkText == singleText, "trial %u, %lu runs: bulk decodes \"%s\", one at a time \"%s\"", trial,
+           static_cast< unsigned long >( runs.size() ), bulkText.c_str(), singleText.c_str() );
+  }
+}
+
+int main()
+{
+  Check check( "classifycheck" );
+  std::printf( "classifycheck: %s kernel and slower\n", RunClassifier::kernel() );
+
+  checkClassify( check );
+  checkDecoder( check );
+
+  return check.finish();
+}
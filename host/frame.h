@@ -0,0 +1,117 @@
+/*
+  frame.h
+
+  Framing for morsed, the local Morse code service (see morsed.cpp), and its clients. Requests and
+  replies are frames: a header, then a payload of header.length bytes. All integers are little endian.
+
+    offset 0   length   payload bytes, at most MAX_PAYLOAD
+    offset 4   id       chosen by the client, and copied into the reply
+    offset 8   op       Op the request asks for; copied into the reply
+    offset 9   status   0 in requests; Status of the reply
+    offset 10  reserved 2 bytes of 0
+
+  Payloads:
+
+    ENCODE         text in, dot/dash notation (see notation.h) out
+    DECODE         notation in, text out
+    RENDER         text in, keyed tone out as 16-bit mono PCM at the service's rate and frequency
+    DECODE_TIMING  key runs in, as 32-bit millisecond durations alternating key down and key up,
+                   starting with key down; text out
+
+  A connection carries any number of requests, and replies come back in the order they were sent.
+  Each request is decoded or encoded on its own, from a fresh start.
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+class Frame
+{
+  public:
+  //
+  // Types
+  //
+
+  enum Op { ENCODE = 1, DECODE, RENDER, DECODE_TIMING };
+
+  enum Status
+  {
+    OK,
+    BAD_REQUEST,  // Unknown op, or a payload that isn't what the op takes.
+    TOO_LONG      // The reply would be longer than MAX_REPLY.
+  };
+
+  struct Header
+  {
+    uint32_t      length;
+    uint32_t      id;
+    unsigned char op;
+    unsigned char status;
+  };
+
+  //
+  // Constants
+  //
+
+  static const size_t   HEADER_LENGTH = 12;
+  static const uint32_t MAX_PAYLOAD = 1 << 24;  // Longest request the service reads.
+  static const uint32_t MAX_REPLY = 1 << 26;    // Longest reply the service sends.
+
+  //
+  // Interface functions
+  //
+
+  // putHeader()
+  // Arguments:
+  //   header - Header to write.
+  //   bytes - Storage for HEADER_LENGTH bytes.
+  static void putHeader( const Header & header, unsigned char * const bytes )
+  {
+    putUint32( header.length, bytes );
+    putUint32( header.id, bytes + 4 );
+    bytes[ 8 ] = header.op;
+    bytes[ 9 ] = header.status;
+    bytes[ 10 ] = 0;
+    bytes[ 11 ] = 0;
+  }
+
+  // getHeader()
+  // Arguments:
+  //   bytes - HEADER_LENGTH bytes.
+  // Returns:
+  //   The header they hold.
+  static Header getHeader( const unsigned char * const bytes )
+  {
+    Header header;
+    header.length = getUint32( bytes );
+    header.id = getUint32( bytes + 4 );
+    header.op = bytes[ 8 ];
+    header.status = bytes[ 9 ];
+    return header;
+  }
+
+  static void putUint32( const uint32_t value, unsigned char * const bytes )
+  {
+    bytes[ 0 ] = static_cast< unsigned char >( value );
+    bytes[ 1 ] = static_cast< unsigned char >( value >> 8 );
+    bytes[ 2 ] = static_cast< unsigned char >( value >> 16 );
+    bytes[ 3 ] = static_cast< unsigned char >( value >> 24 );
+  }
+
+  static uint32_t getUint32( const unsigned char * const bytes )
+  {
+    return static_cast< uint32_t >( bytes[ 0 ] ) | static_cast< uint32_t >( bytes[ 1 ] ) << 8 |
+           static_cast< uint32_t >( bytes[ 2 ] ) << 16 | static_cast< uint32_t >( bytes[ 3 ] ) << 24;
+  }
+};
+
+#endif
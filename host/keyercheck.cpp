@@ -0,0 +1,190 @@
+/*
+  keyercheck.cpp
+
+  Checks the iambic keyer (keyer.h): element and space lengths at several speeds, squeezes in Iambic A
+  and B, paddle memory, and that timing holds to the DOT grid when loop() samples the paddles late.
+
+  Usage: keyercheck
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <string>
+#include <vector>
+#include "WProgram.h"
+#include "check.h"
+#include "keyer.h"
+
+// Typedefs
+
+// When a paddle is held, in milliseconds from the start.
+struct Press
+{
+  unsigned long start;
+  unsigned long end;
+};
+
+// Keyer output, as loop() would see it.
+struct Keying
+{
+  std::string                  elements;  // '.' and '-', from sample()'s reports.
+  std::vector< unsigned long > edges;     // Times keyed() changed, starting with key down.
+};
+
+// key()
+// Arguments:
+//   mode - Iambic A or B.
+//   dot - DOT length, in milliseconds.
+//   dits, dahs - When each paddle is held.
+//   duration - How long to run, in milliseconds.
+//   step - Milliseconds between samples, as if loop() were busy.
+static Keying key( const IambicKeyer::Mode mode, const unsigned long dot, const std::vector< Press > & dits,
+                   const std::vector< Press > & dahs, const unsigned long duration, const unsigned long step = 1 )
+{
+  IambicKeyer keyer;
+  keyer.setMode( mode );
+  keyer.setDotDuration( dot );
+
+  Keying keying;
+  bool keyed = false;
+  for ( unsigned long now = 0; now < duration; now += step )
+  {
+    int levels[ 2 ] = { HIGH, HIGH };
+    const std::vector< Press > * const paddles[ 2 ] = { &dits, &dahs };
+    for ( unsigned int paddle = 0; paddle < 2; ++paddle )
+    {
+      for ( size_t idx = 0; idx < paddles[ paddle ]->size(); ++idx )
+      {
+        if ( now >= ( *paddles[ paddle ] )[ idx ].start && now < ( *paddles[ paddle ] )[ idx ].end )
+        {
+          levels[ paddle ] = LOW;
+        }
+      }
+    }
+
+    if ( keyer.sample( now, levels[ 0 ], levels[ 1 ] ) )
+    {
+      keying.elements += keyer.element() == Morse::DOT ? '.' : '-';
+    }
+    if ( keyer.keyed() != keyed )
+    {
+      keyed = !keyed;
+      keying.edges.push_back( now );
+    }
+  }
+  return keying;
+}
+
+static std::vector< Press > held( const unsigned long start, const unsigned long end )
+{
+  const Press press = { start, end };
+  return std::vector< Press >( 1, press );
+}
+
+static const std::vector< Press > none;
+
+// checkTiming()
+// Arguments:
+//   keying - From key(), with one sample a millisecond.
+//   elements - Lengths of the elements expected, in DOTs.
+//   dot - DOT length, in milliseconds.
+// Checks every element and the space after it, one DOT, are exactly as long as they should be.
+static bool checkTiming( const Keying & keying, const std::vector< unsigned long > & elements, const unsigned long dot )
+{
+  if ( keying.edges.size() != 2 * elements.size() )
+  {
+    return false;
+  }
+  for ( size_t idx = 0; idx < elements.size(); ++idx )
+  {
+    const unsigned long on = keying.edges[ 2 * idx + 1 ] - keying.edges[ 2 * idx ];
+    if ( on != elements[ idx ] * dot ||
+         ( idx + 1 < elements.size() && keying.edges[ 2 * idx + 2 ] - keying.edges[ 2 * idx + 1 ] != dot ) )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void checkHeld( Check & check )
+{
+  const unsigned long speeds[] = { 100, 60, 40, 240 };
+  for ( unsigned int speed = 0; speed < sizeof( speeds ) / sizeof( speeds[ 0 ] ); ++speed )
+  {
+    const unsigned long dot = speeds[ speed ];
+
+    // Held for nine DOTs: DOTs start every two, so five of them.
+    const Keying dits = key( IambicKeyer::IAMBIC_B, dot, held( 0, 9 * dot ), none, 20 * dot );
+    check( dits.elements == ".....", "dit held at %lu ms sends \"%s\"", dot, dits.elements.c_str() );
+    check( checkTiming( dits, std::vector< unsigned long >( 5, 1 ), dot ), "DOT timing at %lu ms", dot );
+
+    // Held for nine DOTs: DASHes start every four, so three of them.
+    const Keying dahs = key( IambicKeyer::IAMBIC_B, dot, none, held( 0, 9 * dot ), 20 * dot );
+    check( dahs.elements == "---", "dah held at %lu ms sends \"%s\"", dot, dahs.elements.c_str() );
+    check( checkTiming( dahs, std::vector< unsigned long >( 3, 3 ), dot ), "DASH timing at %lu ms", dot );
+
+    // A squeeze alternates, starting with the DOT when both go down together.
+    const Keying squeeze = key( IambicKeyer::IAMBIC_A, dot, held( 0, 11 * dot ), held( 0, 11 * dot ), 20 * dot );
+    const unsigned long lengths[] = { 1, 3, 1, 3 };
+    check( squeeze.elements == ".-.-", "squeeze at %lu ms sends \"%s\"", dot, squeeze.elements.c_str() );
+    check( checkTiming( squeeze, std::vector< unsigned long >( lengths, lengths + 4 ), dot ), "squeeze timing at %lu ms", dot );
+  }
+}
+
+static void checkModes( Check & check )
+{
+  // Dit, squeeze in the dah half way through the DOT, and let go of both during the DASH.
+  const Keying a = key( IambicKeyer::IAMBIC_A, 100, held( 0, 250 ), held( 50, 250 ), 2000 );
+  const Keying b = key( IambicKeyer::IAMBIC_B, 100, held( 0, 250 ), held( 50, 250 ), 2000 );
+  check( a.elements == ".-", "Iambic A squeeze released sends \"%s\", not A", a.elements.c_str() );
+  check( b.elements == ".-.", "Iambic B squeeze released sends \"%s\", not R", b.elements.c_str() );
+
+  // A dah tapped and let go during a DOT is remembered, in either mode.
+  for ( int mode = IambicKeyer::IAMBIC_A; mode <= IambicKeyer::IAMBIC_B; ++mode )
+  {
+    const Keying memory = key( static_cast< IambicKeyer::Mode >( mode ), 100, held( 0, 50 ), held( 20, 40 ), 1000 );
+    check( memory.elements == ".-", "dah tapped during a DOT in mode %d sends \"%s\"", mode, memory.elements.c_str() );
+  }
+
+  // A dit tapped during the space after a DASH goes next.
+  const Keying space = key( IambicKeyer::IAMBIC_A, 100, held( 320, 340 ), held( 0, 100 ), 1000 );
+  check( space.elements == "-.", "dit tapped in the space after a DASH sends \"%s\"", space.elements.c_str() );
+
+  // Nothing held, nothing sent.
+  check( key( IambicKeyer::IAMBIC_B, 100, none, none, 1000 ).elements.empty(), "idle keyer sends nothing" );
+}
+
+static void checkLateSamples( Check & check )
+{
+  // loop() sampling every 7 ms: each element starts late by up to a sample, but no later, however
+  // many there have been, because the keyer times each one from when the last should have ended.
+  const unsigned long dot = 60;
+  const unsigned long step = 7;
+  const Keying late = key( IambicKeyer::IAMBIC_B, dot, held( 0, 60 * dot ), none, 61 * dot, step );
+  check( late.elements == std::string( 30, '.' ), "late samples send %lu DOTs, not 30",
+         static_cast< unsigned long >( late.elements.size() ) );
+
+  bool onGrid = late.edges.size() == 60;
+  for ( size_t idx = 0; onGrid && idx < late.edges.size(); ++idx )
+  {
+    const unsigned long ideal = idx * dot;
+    onGrid = late.edges[ idx ] >= ideal && late.edges[ idx ] < ideal + step;
+  }
+  check( onGrid, "late samples keep every edge within %lu ms of the DOT grid", step );
+}
+
+int main()
+{
+  Check check( "keyercheck" );
+
+  checkHeld( check );
+  checkModes( check );
+  checkLateSamples( check );
+
+  return check.finish();
+}
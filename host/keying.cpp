@@ -0,0 +1,226 @@
+/*
+  keying.cpp
+
+  Conversions between Morse code elements and key timing for host programs.
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include "keying.h"
+
+//
+// KeyingSchedule
+//
+
+KeyingSchedule::KeyingSchedule() :
+  gap( 0 ),
+  started( false ),
+  inCharacter( false )
+{
+}
+
+void KeyingSchedule::add( const MorseStream::Symbol symbol, std::vector< unsigned long > & runs )
+{
+  switch ( symbol )
+  {
+    case MorseStream::DOT:
+    case MorseStream::DASH:
+      if ( started )
+      {
+        runs.push_back( gap );
+      }
+      if ( symbol == MorseStream::DOT )
+      {
+        runs.push_back( static_cast< unsigned long >( Morse::DOT_DURATION ) );
+      }
+      else
+      {
+        runs.push_back( static_cast< unsigned long >( Morse::DASH_DURATION ) );
+      }
+      gap = Morse::KEY_SPACE_DURATION;
+      started = true;
+      inCharacter = true;
+      break;
+    case MorseStream::END_OF_CHARACTER:
+      if ( inCharacter )
+      {
+        // KEY_SPACE, then the rest of LETTER_SPACE.
+        gap = Morse::LETTER_SPACE_DURATION;
+        inCharacter = false;
+      }
+      break;
+    case MorseStream::END_OF_WORD:
+      // AsciiToMorse holds the line low for the rest of WORD_SPACE, then goes through KEY_SPACE and
+      // LETTER_SPACE like any other character.
+      gap += Morse::WORD_SPACE_DURATION - Morse::KEY_SPACE_DURATION;
+      break;
+  }
+}
+
+void KeyingSchedule::addCharacter( const char character, std::vector< unsigned char > & symbols, std::vector< unsigned long > & runs )
+{
+  if ( character == ' ' )
+  {
+    // SPACE is a special case.
+    symbols.push_back( MorseStream::END_OF_WORD );
+    add( MorseStream::END_OF_WORD, runs );
+    return;
+  }
+
+  Morse::MorseCodeElement codeword[ Morse::SEQUENCE_LENGTH ];
+  if ( !Morse::asciiToMorse( character, codeword ) )
+  {
+    return;
+  }
+
+  for ( unsigned int idx = 0; idx < Morse::SEQUENCE_LENGTH && codeword[ idx ] != Morse::SPACE; ++idx )
+  {
+    symbols.push_back( codeword[ idx ] );
+    add( static_cast< MorseStream::Symbol >( codeword[ idx ] ), runs );
+  }
+  symbols.push_back( MorseStream::END_OF_CHARACTER );
+  add( MorseStream::END_OF_CHARACTER, runs );
+}
+
+void KeyingSchedule::finish( std::vector< unsigned long > & runs )
+{
+  if ( started )
+  {
+    runs.push_back( gap );
+  }
+
+  gap = 0;
+  started = false;
+  inCharacter = false;
+}
+
+//
+// RunDecoder
+//
+
+RunDecoder::RunDecoder() :
+  now( 0 ),
+  keyDown( true ),
+  noiseSinceKeypress( false )
+{
+  decoder.setOutput( output );
+}
+
+void RunDecoder::add( const unsigned long duration, std::string & text )
+{
+  now += duration;
+
+  if ( keyDown )
+  {
+    // Key released. Classify it the way loop() does.
+    const Morse::MorseCodeElement key = Morse::classifyMark( duration );
+    if ( key != Morse::SPACE )
+    {
+      decoder.keypress( key, now );
+    }
+  }
+  else
+  {
+    // loop() polls the decoder all through a key up run. Polling at its end twice gives the same
+    // result: once to end the letter, and once more to end the word.
+    decoder.timestamp( now );
+    collect( text );
+    decoder.timestamp( now );
+  }
+
+  collect( text );
+  keyDown = !keyDown;
+}
+
+void RunDecoder::add( const unsigned long * const runs, const size_t count, std::string & text )
+{
+  symbols.resize( count );
+  classifier.classify( runs, count, keyDown, symbols.data() );
+
+  for ( size_t idx = 0; idx < count; ++idx )
+  {
+    now += runs[ idx ];
+
+    switch ( symbols[ idx ] )
+    {
+      case RunClassifier::DOT:
+      case RunClassifier::DASH:
+        decoder.keypress( static_cast< Morse::MorseCodeElement >( symbols[ idx ] ), now );
+        noiseSinceKeypress = false;
+        break;
+      case RunClassifier::NOISE:
+        noiseSinceKeypress = true;
+        break;
+      case RunClassifier::ELEMENT_GAP:
+        if ( noiseSinceKeypress )
+        {
+          decoder.timestamp( now );
+          collect( text );
+          decoder.timestamp( now );
+        }
+        break;
+      case RunClassifier::LETTER_GAP:
+        decoder.timestamp( now );
+        if ( noiseSinceKeypress )
+        {
+          collect( text );
+          decoder.timestamp( now );
+        }
+        break;
+      default:
+        // WORD_GAP
+        decoder.timestamp( now );
+        collect( text );
+        decoder.timestamp( now );
+        break;
+    }
+
+    collect( text );
+  }
+
+  if ( count % 2 != 0 )
+  {
+    keyDown = !keyDown;
+  }
+}
+
+void RunDecoder::finish( std::string & text )
+{
+  if ( keyDown )
+  {
+    // Runs ended with key up. An empty key down keeps the polarity right.
+    add( 0, text );
+  }
+
+  // Then wait out the word.
+  add( Morse::WORD_SPACE_DURATION + 1, text );
+}
+
+void RunDecoder::reset()
+{
+  decoder = MorseToAscii();
+  decoder.setOutput( output );
+
+  char character;
+  while ( output.pop( character ) )
+  {
+  }
+
+  now = 0;
+  keyDown = true;
+  noiseSinceKeypress = false;
+}
+
+void RunDecoder::collect( std::string & text )
+{
+  char character;
+
+  while ( output.pop( character ) )
+  {
+    text.push_back( character );
+  }
+}
@@ -0,0 +1,106 @@
+/*
+  keying.h
+
+  Conversions between Morse code elements and key timing for host programs. KeyingSchedule produces the
+  key down / key up runs AsciiToMorse keys for a stream of symbols, and RunDecoder feeds runs through the
+  sketch's own classification and MorseToAscii, just as loop() does with a live key.
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#ifndef KEYING_H
+#define KEYING_H
+
+#include <string>
+#include <vector>
+#include "classify.h"
+#include "morsestream.h"
+#include "morsetoascii.h"
+#include "outputqueue.h"
+
+class KeyingSchedule
+{
+  public:
+  // Constructor
+  KeyingSchedule();
+
+  // add()
+  // Arguments:
+  //   symbol - next symbol to key.
+  //   runs - where runs are appended. Runs alternate key down and key up, starting with key down.
+  // Appends the runs that key the symbol, with AsciiToMorse's timing.
+  void add( const MorseStream::Symbol symbol, std::vector< unsigned long > & runs );
+
+  // addCharacter()
+  // Arguments:
+  //   character - ASCII character to key. SPACE keys the end of a word.
+  //   symbols - where the character's symbols are appended.
+  //   runs - where runs are appended.
+  // Encodes a character with Morse::asciiToMorse(), and keys it. Characters that cannot be encoded are
+  // skipped, as AsciiToMorse does.
+  void addCharacter( const char character, std::vector< unsigned char > & symbols, std::vector< unsigned long > & runs );
+
+  // finish()
+  // Arguments:
+  //   runs - where the final key up run is appended.
+  void finish( std::vector< unsigned long > & runs );
+
+  private:
+  unsigned long gap;          // Key up time owed before the next element.
+  bool          started;      // An element has been keyed.
+  bool          inCharacter;  // An element has been keyed since the last end of character.
+};
+
+class RunDecoder
+{
+  public:
+  // Constructor
+  RunDecoder();
+
+  // add()
+  // Arguments:
+  //   duration - next run, in milliseconds. Runs alternate key down and key up, starting with key down.
+  //   text - where decoded characters are appended.
+  void add( const unsigned long duration, std::string & text );
+
+  // add()
+  // Arguments:
+  //   runs - next runs, in milliseconds.
+  //   count - number of runs.
+  //   text - where decoded characters are appended.
+  // Same as adding the runs one at a time, but classifies them in bulk first, and only wakes the
+  // decoder for gaps that end something.
+  void add( const unsigned long * const runs, const size_t count, std::string & text );
+
+  // finish()
+  // Arguments:
+  //   text - where the last decoded characters are appended.
+  // Lets enough time pass for the decoder to finish the last character and word.
+  void finish( std::string & text );
+
+  // reset()
+  // Starts decoding over, as a new RunDecoder would, but keeps the storage already allocated.
+  void reset();
+
+  private:
+  MorseToAscii                 decoder;
+  OutputQueue                  output;
+  RunClassifier                classifier;
+  std::vector< unsigned char > symbols;
+  unsigned long                now;      // Virtual time, in milliseconds.
+  bool                         keyDown;  // Polarity of the next run.
+
+  // Noise isn't a keypress, so gaps after it count from the keypress before it, and have to be left to
+  // the decoder to judge.
+  bool                         noiseSinceKeypress;
+
+  // collect()
+  // Moves decoded characters from the decoder's queue to text.
+  void collect( std::string & text );
+};
+
+#endif
@@ -0,0 +1,195 @@
+/*
+  keyinputcheck.cpp
+
+  Checks the key debouncer (keyinput.h): contact bounce inside the lockout window is counted and
+  ignored, keypresses are timed from their first edge, and the dot estimate follows the sender's
+  speed, so that MorseToAscii decodes fast and slow senders the way loop() drives it.
+
+  Usage: keyinputcheck
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <string>
+#include "WProgram.h"
+#include "check.h"
+#include "keyinput.h"
+#include "morse.h"
+#include "morsetoascii.h"
+#include "outputqueue.h"
+
+// Drives a KeyInput and a MorseToAscii one millisecond at a time, as loop() does.
+class Keyer
+{
+  public:
+  explicit Keyer( const bool decode ) :
+    now( 1000 ),
+    releases( 0 ),
+    decode( decode )
+  {
+    mta.setOutput( output );
+  }
+
+  // hold()
+  // Arguments:
+  //   level - Level of the key pin.
+  //   duration - How long to hold it, in milliseconds.
+  //   bounces - Extra changes in level, one millisecond apart, at the start.
+  void hold( const int level, const unsigned long duration, const unsigned int bounces = 0 )
+  {
+    for ( unsigned long elapsed = 0; elapsed < duration; ++elapsed )
+    {
+      const bool bouncing = elapsed < bounces && elapsed % 2 == 1;
+      tick( bouncing ? ( level == LOW ? HIGH : LOW ) : level );
+    }
+  }
+
+  // send()
+  // Arguments:
+  //   text - Characters to key, spaced the way AsciiToMorse spaces them.
+  //   dot - DOT length, in milliseconds.
+  void send( const char * const text, const unsigned long dot )
+  {
+    for ( const char * character = text; *character != 0; ++character )
+    {
+      if ( *character == ' ' )
+      {
+        hold( HIGH, ( Morse::WORD_SPACE_DURATION - Morse::KEY_SPACE_DURATION ) * dot / Morse::DOT_DURATION );
+        continue;
+      }
+
+      Morse::MorseCodeElement elements[ Morse::SEQUENCE_LENGTH ];
+      Morse::asciiToMorse( *character, elements );
+      for ( unsigned int idx = 0; idx < Morse::SEQUENCE_LENGTH && elements[ idx ] != Morse::SPACE; ++idx )
+      {
+        hold( LOW, elements[ idx ] == Morse::DOT ? dot : 3 * dot );
+        hold( HIGH, dot );
+      }
+      hold( HIGH, ( Morse::LETTER_SPACE_DURATION - Morse::KEY_SPACE_DURATION ) * dot / Morse::DOT_DURATION );
+    }
+  }
+
+  // text()
+  // Returns:
+  //   What MorseToAscii has decoded so far.
+  std::string text()
+  {
+    char character;
+    while ( output.pop( character ) )
+    {
+      decoded += character;
+    }
+    return decoded;
+  }
+
+  KeyInput      key;
+  unsigned long now;
+  unsigned long releases;
+
+  private:
+  MorseToAscii mta;
+  OutputQueue  output;
+  std::string  decoded;
+  bool         decode;
+
+  void tick( const int level )
+  {
+    hostSetTime( now * 1000 );
+    if ( decode && key.state() == KeyInput::KEY_UP )
+    {
+      mta.timestamp( now );
+    }
+    if ( key.sample( now, level ) )
+    {
+      ++releases;
+      if ( decode )
+      {
+        mta.setDotDuration( key.dotEstimate() );
+        const Morse::MorseCodeElement element = Morse::classifyMark( key.keyDuration(), mta.dotDuration() );
+        if ( element != Morse::SPACE )
+        {
+          mta.keypress( element, now );
+        }
+      }
+    }
+    ++now;
+  }
+};
+
+static void checkDebounce( Check & check )
+{
+  Keyer keyer( false );
+
+  keyer.hold( HIGH, 500 );
+  keyer.hold( LOW, 100 );
+  keyer.hold( HIGH, 100 );
+  check( keyer.releases == 1 && keyer.key.keyDuration() == 100, "clean keypress lasts %lu ms", keyer.key.keyDuration() );
+  check( keyer.key.edgeCount() == 2 && keyer.key.bounceCount() == 0, "clean keypress has 2 edges, no bounces" );
+
+  // Four bounces after each edge, well inside the 25 ms lockout at 100 ms dots.
+  keyer.hold( LOW, 300, 8 );
+  keyer.hold( HIGH, 100, 8 );
+  check( keyer.releases == 2 && keyer.key.keyDuration() == 300, "bouncing keypress lasts %lu ms", keyer.key.keyDuration() );
+  check( keyer.key.edgeCount() == 4, "bounces are not edges: %lu edges", keyer.key.edgeCount() );
+  check( keyer.key.bounceCount() == 16 && keyer.key.longestBounce() == 8,
+         "%lu bounces ignored, longest %lu ms", keyer.key.bounceCount(), keyer.key.longestBounce() );
+
+  // A glitch that is over before the lockout window ends is released when it does, and is too short
+  // to move the dot estimate.
+  const unsigned long dot = keyer.key.dotEstimate();
+  keyer.hold( LOW, 2 );
+  keyer.hold( HIGH, 100 );
+  check( keyer.releases == 3 && keyer.key.keyDuration() == 2, "glitch lasts %lu ms", keyer.key.keyDuration() );
+  check( keyer.key.dotEstimate() == dot, "glitch leaves the dot estimate at %lu ms, not %lu", dot, keyer.key.dotEstimate() );
+  check( Morse::classifyMark( keyer.key.keyDuration(), dot ) == Morse::SPACE, "glitch is classified as noise" );
+}
+
+// checkSpeed()
+// Arguments:
+//   dot - Sender's DOT length, in milliseconds.
+static void checkSpeed( Check & check, const unsigned long dot )
+{
+  Keyer keyer( true );
+  keyer.hold( HIGH, 500 );
+  keyer.send( "PARIS PARIS ", dot );
+
+  const unsigned long estimate = keyer.key.dotEstimate();
+  check( estimate * 10 >= dot * 9 && estimate * 10 <= dot * 11, "%lu ms dots estimated at %lu ms", dot, estimate );
+
+  unsigned long lockout = dot / 4;
+  lockout = lockout < KeyInput::MIN_LOCKOUT ? KeyInput::MIN_LOCKOUT : lockout > KeyInput::MAX_LOCKOUT ? KeyInput::MAX_LOCKOUT : lockout;
+  check( keyer.key.lockout() + 2 >= lockout && keyer.key.lockout() <= lockout + 2,
+         "lockout %lu ms at %lu ms dots", keyer.key.lockout(), dot );
+
+  check( Morse::classifyMark( dot, estimate ) == Morse::DOT && Morse::classifyMark( 3 * dot, estimate ) == Morse::DASH,
+         "%lu ms marks classified at %lu ms dots", dot, estimate );
+
+  // Once the estimate has settled, everything decodes. The first letter can go while it does.
+  keyer.send( "THE QUICK BROWN FOX 73 ", dot );
+  const std::string text = keyer.text();
+  const std::string settled = "PARIS THE QUICK BROWN FOX 73 ";
+  check( text.size() >= settled.size() && text.compare( text.size() - settled.size(), settled.size(), settled ) == 0,
+         "%lu ms dots decode as \"%s\"", dot, text.c_str() );
+}
+
+int main()
+{
+  Check check( "keyinputcheck" );
+
+  checkDebounce( check );
+  checkSpeed( check, 100 );
+  checkSpeed( check, 60 );   // 20 WPM.
+  checkSpeed( check, 40 );   // 30 WPM.
+  checkSpeed( check, 200 );  // 6 WPM.
+
+  // Without an estimate, the thresholds are the sketch's own.
+  check( Morse::classifyMark( Morse::NOISE_THRESHOLD - 1 ) == Morse::SPACE, "default noise threshold" );
+  check( Morse::classifyMark( Morse::DASH_THRESHOLD - 1 ) == Morse::DOT, "default dash threshold" );
+  check( Morse::classifyMark( Morse::DASH_THRESHOLD ) == Morse::DASH, "default dash threshold" );
+
+  return check.finish();
+}
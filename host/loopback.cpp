@@ -0,0 +1,515 @@
+/*
+  loopback.cpp
+
+  End to end benchmark of the codec. Takes each line of a text corpus through the whole chain:
+
+    text -> KeyingSchedule (Morse::asciiToMorse, AsciiToMorse timing) -> runs
+         -> impairments -> [ToneRenderer -> audio impairments -> EnvelopeDetector] -> runs
+         -> RunDecoder (MorseToAscii) -> text
+
+  and compares what comes out with what went in. The part in brackets runs with -p audio; with -p runs
+  the impaired key timing goes straight to the decoder.
+
+  Impairments:
+    -j ms       jitter: every run is off by a normally distributed amount, this many ms standard deviation
+    -d percent  speed drift: the sending speed wanders this far either way, once every -P seconds
+    -n dB       noise: white noise this far below the tone's power (audio only)
+    -f depth    fading: the tone fades by up to this fraction, once every -P seconds (audio only)
+
+  Drift and fading carry on from one line to the next, as if the corpus were sent in one go. Random
+  impairments come from -s seed, so a run can be repeated exactly.
+
+  Writes one JSON object to standard output: the settings, characters per second through the whole
+  chain and through the codec alone (leaving out the time spent impairing), CPU time per character,
+  time per character in each stage, the latency of a line from text in to text out, and the character
+  error rate, the edit distance between what was sent and what was decoded over the number of
+  characters sent. Only characters Morse code has, in upper case, with blanks run together, count as
+  sent. The times cover the chain alone: each line is scored after its clocks stop.
+
+  Usage: loopback [-p runs|audio] [-j ms] [-d percent] [-P seconds] [-n dB] [-f depth] [-r rate]
+                  [-R repeats] [-s seed] [corpus]
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <random>
+#include <string>
+#include <vector>
+#include "audio.h"
+#include "keying.h"
+
+// Typedefs
+typedef std::chrono::steady_clock Clock;
+
+enum Path { RUNS, AUDIO };
+
+struct Options
+{
+  Path          path;
+  double        jitter;       // ms standard deviation.
+  double        drift;        // Fraction of the speed.
+  double        period;       // Seconds.
+  double        snr;          // dB. Infinite for no noise.
+  double        fading;       // Fraction of the amplitude.
+  unsigned int  sampleRate;
+  unsigned long repeats;
+  unsigned long seed;
+  const char *  corpusPath;
+};
+
+// Stages of the chain, for timing.
+enum Stage { ENCODE, IMPAIR, RENDER, DETECT, DECODE, STAGE_COUNT };
+
+// Constants
+static const double pi = 3.14159265358979323846;
+static const double frequency = 600.0;        // Hz
+static const double amplitude = 0.5;          // Of full scale.
+static const double ramp = 5.0;               // ms
+static const char * const stageNames[ STAGE_COUNT ] = { "encode", "impair", "render", "detect", "decode" };
+
+// Applies the impairments, keeping track of time across lines so drift and fading carry on.
+class Channel
+{
+  public:
+  Channel( const Options & options ) :
+    options( options ),
+    random( options.seed ),
+    normal( 0.0, 1.0 ),
+    runTime( 0.0 ),
+    sampleCount( 0 ),
+    noiseLevel( std::isinf( options.snr ) ? 0.0 : amplitude * 32767.0 / std::sqrt( 2.0 ) * std::pow( 10.0, -options.snr / 20.0 ) )
+  {
+  }
+
+  // impairRuns()
+  // Arguments:
+  //   runs - key timing, in milliseconds. Changed in place.
+  // Stretches the runs by the speed at the time, and adds jitter. No run gets shorter than 1 ms, so
+  // key down and key up still alternate.
+  void impairRuns( std::vector< unsigned long > & runs )
+  {
+    for ( size_t idx = 0; idx < runs.size(); ++idx )
+    {
+      double duration = runs[ idx ];
+      if ( options.drift != 0.0 )
+      {
+        duration /= 1.0 + options.drift * std::sin( 2.0 * pi * runTime / 1000.0 / options.period );
+      }
+      if ( options.jitter != 0.0 )
+      {
+        duration += options.jitter * normal( random );
+      }
+      runTime += runs[ idx ];
+      runs[ idx ] = duration < 1.0 ? 1 : static_cast< unsigned long >( duration + 0.5 );
+    }
+  }
+
+  // impairAudio()
+  // Arguments:
+  //   pcm - little endian 16-bit audio. Changed in place.
+  // Fades the audio, then adds noise.
+  void impairAudio( std::vector< unsigned char > & pcm )
+  {
+    if ( options.fading == 0.0 && noiseLevel == 0.0 )
+    {
+      sampleCount += pcm.size() / 2;
+      return;
+    }
+
+    for ( size_t idx = 0; idx + 1 < pcm.size(); idx += 2 )
+    {
+      const double time = static_cast< double >( sampleCount++ ) / options.sampleRate;
+      const double gain = 1.0 - options.fading * ( 0.5 - 0.5 * std::cos( 2.0 * pi * time / options.period ) );
+      const int16_t sample = static_cast< int16_t >( pcm[ idx ] | pcm[ idx + 1 ] << 8 );
+      double value = sample * gain;
+      if ( noiseLevel != 0.0 )
+      {
+        value += noiseLevel * normal( random );
+      }
+
+      const long rounded = std::lround( std::max( -32768.0, std::min( 32767.0, value ) ) );
+      pcm[ idx ] = static_cast< unsigned char >( rounded & 0xFF );
+      pcm[ idx + 1 ] = static_cast< unsigned char >( ( rounded >> 8 ) & 0xFF );
+    }
+  }
+
+  private:
+  const Options &                    options;
+  std::mt19937                       random;
+  std::normal_distribution< double > normal;
+  double                             runTime;      // ms of runs impaired so far.
+  unsigned long long                 sampleCount;  // Samples impaired so far.
+  const double                       noiseLevel;   // Noise standard deviation, in sample units.
+};
+
+// normalize()
+// Arguments:
+//   text - text as sent or decoded.
+//   decoded - text is decoded, so '?' stands for a character the decoder couldn't read.
+// Returns:
+//   What Morse code can carry of it: upper case letters and digits, words separated by one SPACE,
+//   with none at either end. Decoded text keeps its '?'s, to count as errors.
+static std::string normalize( const std::string & text, const bool decoded )
+{
+  std::string result;
+  bool space = false;
+
+  for ( size_t idx = 0; idx < text.size(); ++idx )
+  {
+    const unsigned char character = static_cast< unsigned char >( text[ idx ] );
+    if ( std::isspace( character ) )
+    {
+      space = !result.empty();
+    }
+    else if ( std::isalnum( character ) || ( decoded && character == '?' ) )
+    {
+      if ( space )
+      {
+        result.push_back( ' ' );
+        space = false;
+      }
+      result.push_back( static_cast< char >( std::toupper( character ) ) );
+    }
+  }
+
+  return result;
+}
+
+// bandedDistance()
+// Arguments:
+//   band - How far from the diagonal to look. At least the difference in length.
+// Returns:
+//   Levenshtein distance between two strings, if it is no more than band. Something over band if not.
+static size_t bandedDistance( const std::string & from, const std::string & to, const size_t band )
+{
+  // Cells outside the band count as out of reach.
+  const size_t unreachable = from.size() + to.size() + 1;
+  std::vector< size_t > previous( to.size() + 1, unreachable );
+  std::vector< size_t > current( to.size() + 1, unreachable );
+  for ( size_t column = 0; column <= std::min( to.size(), band ); ++column )
+  {
+    previous[ column ] = column;
+  }
+
+  for ( size_t row = 1; row <= from.size(); ++row )
+  {
+    const size_t first = row > band ? row - band : 0;
+    const size_t last = std::min( to.size(), row + band );
+    size_t column = first;
+    if ( first == 0 )
+    {
+      current[ 0 ] = row;
+      column = 1;
+    }
+    else
+    {
+      current[ first - 1 ] = unreachable;
+    }
+
+    for ( ; column <= last; ++column )
+    {
+      const size_t change = previous[ column - 1 ] + ( from[ row - 1 ] != to[ column - 1 ] );
+      current[ column ] = std::min( change, std::min( previous[ column ], current[ column - 1 ] ) + 1 );
+    }
+    if ( last < to.size() )
+    {
+      current[ last + 1 ] = unreachable;
+    }
+    previous.swap( current );
+  }
+
+  return previous[ to.size() ];
+}
+
+// editDistance()
+// Returns:
+//   Levenshtein distance between two strings: the fewest characters inserted, deleted or changed to
+//   turn one into the other.
+// Only cells near the diagonal are worked out, in a band that doubles until it holds the answer, so a
+// long line decoded with few errors costs its length times the errors, not its length squared.
+static size_t editDistance( const std::string & from, const std::string & to )
+{
+  const size_t difference = from.size() > to.size() ? from.size() - to.size() : to.size() - from.size();
+  for ( size_t band = std::max< size_t >( difference, 16 ); ; band *= 2 )
+  {
+    const size_t distance = bandedDistance( from, to, band );
+    if ( distance <= band )
+    {
+      return distance;
+    }
+  }
+}
+
+// percentile()
+// Arguments:
+//   sorted - Values in ascending order. Not empty.
+//   fraction - 0 to 1.
+static double percentile( const std::vector< double > & sorted, const double fraction )
+{
+  return sorted[ static_cast< size_t >( fraction * ( sorted.size() - 1 ) ) ];
+}
+
+// elapsed()
+// Returns:
+//   Nanoseconds since start, and restarts the clock.
+static double elapsed( Clock::time_point & start )
+{
+  const Clock::time_point now = Clock::now();
+  const double nanoseconds = std::chrono::duration< double, std::nano >( now - start ).count();
+  start = now;
+  return nanoseconds;
+}
+
+static int usage()
+{
+  std::fprintf( stderr,
+                "usage: loopback [-p runs|audio] [-j ms] [-d percent] [-P seconds] [-n dB] [-f depth] [-r rate]\n"
+                "                [-R repeats] [-s seed] [corpus]\n"
+                "  Sends each line of the corpus through the codec and an impaired channel, and reports\n"
+                "  speed and accuracy as JSON. -n and -f need -p audio.\n"
+                "  Defaults: -p runs -j 0 -d 0 -P 10 -f 0 -r 8000 -R 1 -s 1, no noise, standard input.\n" );
+  return 2;
+}
+
+int main( int argc, char * argv[] )
+{
+  Options options = { RUNS, 0.0, 0.0, 10.0, INFINITY, 0.0, 8000, 1, 1, 0 };
+
+  int arg = 1;
+  for ( ; arg < argc && argv[ arg ][ 0 ] == '-' && argv[ arg ][ 1 ] != 0; ++arg )
+  {
+    if ( argv[ arg ][ 2 ] != 0 || arg + 1 >= argc )
+    {
+      return usage();
+    }
+
+    const char * const value = argv[ ++arg ];
+    switch ( argv[ arg - 1 ][ 1 ] )
+    {
+      case 'p':
+        if ( std::strcmp( value, "runs" ) == 0 )
+        {
+          options.path = RUNS;
+        }
+        else if ( std::strcmp( value, "audio" ) == 0 )
+        {
+          options.path = AUDIO;
+        }
+        else
+        {
+          return usage();
+        }
+        break;
+      case 'j':
+        options.jitter = std::strtod( value, 0 );
+        break;
+      case 'd':
+        options.drift = std::strtod( value, 0 ) / 100.0;
+        break;
+      case 'P':
+        options.period = std::strtod( value, 0 );
+        break;
+      case 'n':
+        options.snr = std::strtod( value, 0 );
+        break;
+      case 'f':
+        options.fading = std::strtod( value, 0 );
+        break;
+      case 'r':
+        options.sampleRate = static_cast< unsigned int >( std::strtoul( value, 0, 10 ) );
+        break;
+      case 'R':
+        options.repeats = std::strtoul( value, 0, 10 );
+        break;
+      case 's':
+        options.seed = std::strtoul( value, 0, 10 );
+        break;
+      default:
+        return usage();
+    }
+  }
+  if ( arg < argc )
+  {
+    options.corpusPath = argv[ arg++ ];
+  }
+  if ( arg < argc || options.jitter < 0.0 || options.drift < 0.0 || options.drift >= 1.0 || options.period <= 0.0 ||
+       options.fading < 0.0 || options.fading > 1.0 || options.sampleRate < 2 * frequency || options.repeats == 0 ||
+       ( options.path == RUNS && ( !std::isinf( options.snr ) || options.fading != 0.0 ) ) )
+  {
+    return usage();
+  }
+
+  std::FILE * const input = ( options.corpusPath == 0 || std::strcmp( options.corpusPath, "-" ) == 0 ) ?
+                            stdin : std::fopen( options.corpusPath, "rb" );
+  if ( input == 0 )
+  {
+    std::perror( options.corpusPath );
+    return 1;
+  }
+
+  std::vector< std::string > lines;
+  std::string line;
+  int character;
+  while ( ( character = std::fgetc( input ) ) != EOF )
+  {
+    if ( character != '\n' )
+    {
+      line.push_back( static_cast< char >( character ) );
+    }
+    else if ( !normalize( line, false ).empty() )
+    {
+      lines.push_back( line );
+      line.clear();
+    }
+    else
+    {
+      line.clear();
+    }
+  }
+  if ( !normalize( line, false ).empty() )
+  {
+    lines.push_back( line );
+  }
+  if ( input != stdin )
+  {
+    std::fclose( input );
+  }
+
+  Channel channel( options );
+  KeyingSchedule schedule;
+  RunDecoder decoder;
+  std::vector< unsigned char > symbols;
+  std::vector< unsigned long > runs;
+  std::vector< unsigned char > pcm;
+  std::string text;
+
+  double stageTime[ STAGE_COUNT ] = { 0.0 };
+  std::vector< double > latencies;
+  unsigned long long characters = 0;
+  unsigned long long errors = 0;
+  unsigned long long keyedTime = 0;   // ms
+
+  // The clocks only run while a line goes through the chain. Scoring it isn't part of the chain.
+  double wallTime = 0.0;          // s
+  std::clock_t cpuClocks = 0;
+
+  for ( unsigned long repeat = 0; repeat < options.repeats; ++repeat )
+  {
+    for ( size_t idx = 0; idx < lines.size(); ++idx )
+    {
+      const std::clock_t cpuStart = std::clock();
+      const Clock::time_point lineStart = Clock::now();
+      Clock::time_point stageStart = lineStart;
+
+      schedule = KeyingSchedule();
+      symbols.clear();
+      runs.clear();
+      for ( size_t lp = 0; lp < lines[ idx ].size(); ++lp )
+      {
+        const char character = std::isspace( static_cast< unsigned char >( lines[ idx ][ lp ] ) ) ? ' ' : lines[ idx ][ lp ];
+        schedule.addCharacter( character, symbols, runs );
+      }
+      schedule.finish( runs );
+      stageTime[ ENCODE ] += elapsed( stageStart );
+
+      channel.impairRuns( runs );
+      for ( size_t lp = 0; lp < runs.size(); ++lp )
+      {
+        keyedTime += runs[ lp ];
+      }
+      stageTime[ IMPAIR ] += elapsed( stageStart );
+
+      if ( options.path == AUDIO )
+      {
+        ToneRenderer tone( options.sampleRate, frequency, amplitude, ramp );
+        pcm.clear();
+        for ( size_t lp = 0; lp < runs.size(); ++lp )
+        {
+          tone.add( runs[ lp ], pcm );
+        }
+        stageTime[ RENDER ] += elapsed( stageStart );
+
+        channel.impairAudio( pcm );
+        stageTime[ IMPAIR ] += elapsed( stageStart );
+
+        EnvelopeDetector detector( options.sampleRate );
+        runs.clear();
+        detector.addBytes( pcm.data(), pcm.size(), runs );
+        detector.finish( runs );
+        stageTime[ DETECT ] += elapsed( stageStart );
+      }
+
+      text.clear();
+      decoder.reset();
+      decoder.add( runs.data(), runs.size(), text );
+      decoder.finish( text );
+      stageTime[ DECODE ] += elapsed( stageStart );
+
+      cpuClocks += std::clock() - cpuStart;
+      const std::chrono::duration< double > lineTime = stageStart - lineStart;
+      wallTime += lineTime.count();
+      latencies.push_back( lineTime.count() * 1e6 );
+
+      const std::string sent = normalize( lines[ idx ], false );
+      characters += sent.size();
+      errors += editDistance( sent, normalize( text, true ) );
+    }
+  }
+
+  const double cpuTime = static_cast< double >( cpuClocks ) / CLOCKS_PER_SEC;
+  const double codecTime = ( stageTime[ ENCODE ] + stageTime[ RENDER ] + stageTime[ DETECT ] + stageTime[ DECODE ] ) / 1e9;
+  const double perCharacter = characters != 0 ? 1.0 / characters : 0.0;
+  std::sort( latencies.begin(), latencies.end() );
+
+  std::printf( "{\n" );
+  std::printf( "  \"path\": \"%s\",\n", options.path == AUDIO ? "audio" : "runs" );
+  std::printf( "  \"impairments\": { \"jitter_ms\": %g, \"drift_percent\": %g, \"period_s\": %g, ",
+               options.jitter, options.drift * 100.0, options.period );
+  if ( std::isinf( options.snr ) )
+  {
+    std::printf( "\"snr_db\": null, " );
+  }
+  else
+  {
+    std::printf( "\"snr_db\": %g, ", options.snr );
+  }
+  std::printf( "\"fading_depth\": %g },\n", options.fading );
+  std::printf( "  \"sample_rate\": %u,\n  \"seed\": %lu,\n  \"repeats\": %lu,\n",
+               options.sampleRate, options.seed, options.repeats );
+  std::printf( "  \"lines\": %lu,\n  \"characters\": %llu,\n  \"signal_seconds\": %.3f,\n",
+               static_cast< unsigned long >( latencies.size() ), characters, keyedTime / 1000.0 );
+  std::printf( "  \"chars_per_second\": %.1f,\n", wallTime > 0.0 ? characters / wallTime : 0.0 );
+  std::printf( "  \"codec_chars_per_second\": %.1f,\n", codecTime > 0.0 ? characters / codecTime : 0.0 );
+  std::printf( "  \"times_real_time\": %.1f,\n", wallTime > 0.0 ? keyedTime / 1000.0 / wallTime : 0.0 );
+  std::printf( "  \"cpu_ns_per_char\": %.1f,\n", cpuTime * 1e9 * perCharacter );
+  std::printf( "  \"stage_ns_per_char\": {" );
+  for ( unsigned int stage = 0; stage < STAGE_COUNT; ++stage )
+  {
+    std::printf( "%s \"%s\": %.1f", stage == 0 ? "" : ",", stageNames[ stage ], stageTime[ stage ] * perCharacter );
+  }
+  std::printf( " },\n" );
+  if ( latencies.empty() )
+  {
+    std::printf( "  \"latency_us\": null,\n" );
+  }
+  else
+  {
+    std::printf( "  \"latency_us\": { \"p50\": %.1f, \"p99\": %.1f, \"max\": %.1f },\n",
+                 percentile( latencies, 0.5 ), percentile( latencies, 0.99 ), latencies.back() );
+  }
+  std::printf( "  \"errors\": %llu,\n  \"cer\": %.6f\n}\n", errors, characters != 0 ? errors * perCharacter : 0.0 );
+
+  return 0;
+}
@@ -0,0 +1,275 @@
+/*
+  macrocheck.cpp
+
+  Checks the message macros (macro.h): commands from the serial port, with any line ending, storing and
+  repeat intervals written to EEPROM in the background, playback stopping when its slot is stored over,
+  and never waiting on an EEPROM write. Off the board, the EEPROM is kept in RAM, and takes as long to
+  write as the chip's.
+
+  Usage: macrocheck
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <climits>
+#include <string>
+#include "WProgram.h"
+#include "check.h"
+#include "macro.h"
+#include "outputqueue.h"
+
+// Constants
+static const unsigned long settleTime = 100;  // ms. Long enough to write a short message to EEPROM.
+
+// Sketch's macro handling, fed from a string as loop() is fed from the serial port.
+class Sketch
+{
+  public:
+  // Constructor
+  // Arguments:
+  //   start - millis() to start at.
+  explicit Sketch( const unsigned long start = 1000 ) :
+    player( macros ),
+    commands( macros, player ),
+    now( start ),
+    stalls( 0 )
+  {
+  }
+
+  // type()
+  // Arguments:
+  //   input - Characters from the serial port.
+  // Returns:
+  //   The characters that weren't part of a command, and would have been sent as Morse code.
+  std::string type( const std::string & input )
+  {
+    std::string text;
+    for ( size_t idx = 0; idx < input.size(); ++idx )
+    {
+      if ( !commands.addChar( input[ idx ], now ) )
+      {
+        // Text takes over from macros.
+        player.stop();
+        text += input[ idx ];
+      }
+      run( 1 );
+    }
+    return text;
+  }
+
+  // run()
+  // Arguments:
+  //   duration - Milliseconds to run for.
+  void run( const unsigned long duration )
+  {
+    for ( unsigned long elapsed = 0; elapsed < duration; ++elapsed )
+    {
+      // The clock moves on if a read waits for an EEPROM write.
+      hostSetTime( now * 1000 );
+      player.timestamp( now );
+      stalls += micros() != now * 1000;
+      macros.service();
+      ++now;
+    }
+  }
+
+  MacroStore    macros;
+  MacroPlayer   player;
+  MacroCommand  commands;
+  unsigned long now;
+  unsigned long stalls;  // Times player.timestamp() waited for EEPROM.
+};
+
+// errors()
+// Returns:
+//   Error messages printed since the last call.
+static std::string errors()
+{
+  std::string printed;
+  char character;
+  while ( serialOutput.pop( character ) )
+  {
+    printed += character;
+  }
+  return printed;
+}
+
+static void checkLineEndings( Check & check )
+{
+  const char * const endings[] = { "\r", "\n", "\r\n" };
+  for ( unsigned int idx = 0; idx < sizeof( endings ) / sizeof( endings[ 0 ] ); ++idx )
+  {
+    Sketch sketch;
+    const std::string ending = endings[ idx ];
+    check( sketch.type( "#S1CQ" + ending ).empty(), "#S with line ending %u is not text", idx );
+    sketch.run( settleTime );
+    check( sketch.macros.symbolCount( 1 ) == 10, "#S with line ending %u stores CQ: %u symbols", idx, sketch.macros.symbolCount( 1 ) );
+
+    check( sketch.type( "#P1" + ending ).empty() && sketch.player.playing(), "#P with line ending %u keeps playing", idx );
+    check( sketch.type( "#x" + ending ).empty() && !sketch.player.playing(), "#x with line ending %u stops", idx );
+    check( errors().empty(), "no errors with line ending %u", idx );
+  }
+
+  // Line ends outside a command are text, as is a line feed after a line feed.
+  Sketch sketch;
+  check( sketch.type( "AB\r\n" ) == "AB\r\n", "line ends after text are text" );
+  check( sketch.type( "#X\n\n" ) == "\n", "second line feed is text" );
+  check( sketch.type( "#X\r\r\n" ) == "\r\n", "second CRLF is text" );
+}
+
+static void checkCommands( Check & check )
+{
+  Sketch sketch;
+
+  sketch.type( "#S0E E\n" );
+  sketch.run( settleTime );
+  check( sketch.macros.symbolCount( 0 ) == 5, "E E is 5 symbols, not %u", sketch.macros.symbolCount( 0 ) );
+
+  // Playback keys the same timing as AsciiToMorse.
+  sketch.type( "#P0\n" );
+  check( sketch.player.keyed(), "#P0 keys the first DOT" );
+  sketch.run( Morse::DOT_DURATION );
+  check( !sketch.player.keyed(), "first DOT over" );
+  sketch.run( Morse::LETTER_SPACE_DURATION + Morse::WORD_SPACE_DURATION - Morse::KEY_SPACE_DURATION - 1 );
+  check( !sketch.player.keyed(), "word space not over" );
+  sketch.run( 1 );
+  check( sketch.player.keyed(), "second DOT keyed after the word space" );
+  sketch.run( Morse::DOT_DURATION + Morse::LETTER_SPACE_DURATION );
+  check( !sketch.player.playing(), "played once" );
+  check( errors().empty(), "no errors playing" );
+
+  // Errors.
+  sketch.type( "#S9E\n" );
+  check( errors().find( "slot not available" ) != std::string::npos, "#S to a missing slot fails" );
+  sketch.type( "#Q0\n" );
+  check( errors().find( "bad macro command" ) != std::string::npos, "unknown command fails" );
+  sketch.type( "#P3\n" );
+  check( errors().find( "bad macro command" ) != std::string::npos, "#P of an empty slot fails" );
+
+  std::string full = "#S2";
+  full.append( MacroStore::SYMBOL_CAPACITY, 'E' );
+  sketch.type( full + "\n" );
+  sketch.run( 4 * MacroStore::SLOT_LENGTH + settleTime );
+  check( errors().find( "macro full" ) != std::string::npos, "overlong message fails" );
+  check( sketch.macros.symbolCount( 2 ) == MacroStore::SYMBOL_CAPACITY, "overlong message keeps %u symbols, not %u",
+         MacroStore::SYMBOL_CAPACITY, sketch.macros.symbolCount( 2 ) );
+}
+
+static void checkRepeat( Check & check )
+{
+  Sketch sketch;
+  sketch.type( "#S3T\n" );
+  sketch.run( settleTime );
+
+  sketch.type( "#R3300\n" );
+  check( sketch.macros.repeat( 3 ) == 300, "repeat reads back as %u before it is written", sketch.macros.repeat( 3 ) );
+
+  // Another store sees only what is in EEPROM.
+  MacroStore eeprom;
+  sketch.run( settleTime );
+  check( eeprom.repeat( 3 ) == 300, "repeat written by service(): %u", eeprom.repeat( 3 ) );
+
+  // The repeat plays the slot again after the pause.
+  sketch.type( "#R31\n#P3\n" );
+  sketch.run( Morse::DASH_DURATION + Morse::LETTER_SPACE_DURATION + 1000 );
+  check( sketch.player.keyed(), "slot repeats after a second" );
+
+  // Storing a message clears its repeat, even one not yet written.
+  sketch.type( "#X\n#R35\n#S3E\n" );
+  sketch.run( settleTime );
+  check( sketch.macros.repeat( 3 ) == 0 && eeprom.repeat( 3 ) == 0, "#S clears the repeat" );
+  check( errors().empty(), "no errors repeating" );
+
+  // Repeat intervals are 2 bytes in EEPROM.
+  sketch.type( "#R3 65535\n" );
+  check( sketch.macros.repeat( 3 ) == 65535 && errors().empty(), "65535 s repeat" );
+  sketch.type( "#R3 70000\n" );
+  check( errors().find( "bad macro command" ) != std::string::npos, "70000 s repeat fails" );
+  check( sketch.macros.repeat( 3 ) == 65535, "failed repeat leaves the interval at %u s", sketch.macros.repeat( 3 ) );
+}
+
+static void checkWrap( Check & check )
+{
+  // millis() wraps during the repeat interval, about 300 ms before it ends.
+  Sketch sketch( ULONG_MAX - 2 * settleTime - Morse::DOT_DURATION - Morse::LETTER_SPACE_DURATION - 600 );
+  sketch.type( "#S0E\n" );
+  sketch.run( settleTime );
+  sketch.type( "#R01\n#P0\n" );
+  sketch.run( settleTime );
+
+  sketch.run( Morse::DOT_DURATION + Morse::LETTER_SPACE_DURATION + 900 - settleTime );
+  check( sketch.player.playing() && !sketch.player.keyed(), "repeat across the wrap waits" );
+  sketch.run( 150 );
+  check( sketch.player.keyed(), "repeat across the wrap plays after a second" );
+}
+
+static void checkStoreOver( Check & check )
+{
+  Sketch sketch;
+  sketch.type( "#S1PARIS\n#S2E\n" );
+  sketch.run( settleTime );
+
+  // Storing another slot leaves playback alone.
+  sketch.type( "#P1\n" );
+  sketch.type( "#S2T" );
+  check( sketch.player.playing(), "storing another slot leaves slot 1 playing" );
+  sketch.type( "\n" );
+  sketch.run( settleTime );
+  check( sketch.player.playing(), "slot 1 still playing" );
+
+  // Storing over the slot playing stops it, and drops the output line.
+  sketch.type( "#S1" );
+  check( !sketch.player.playing() && !sketch.player.keyed(), "storing slot 1 stops it playing" );
+  sketch.type( "E\n" );
+  sketch.run( settleTime );
+  check( sketch.macros.symbolCount( 1 ) == 2, "slot 1 holds its new message" );
+}
+
+static void checkNoWait( Check & check )
+{
+  // Play one slot while a message that fills another is written, which takes about a second. Each
+  // write takes a few loop()s, and the elements all fall at the same point in them, so try each point.
+  // The letters differ so that each message rewrites the last.
+  const char letters[] = { 'H', '5', 'S', 'I' };
+  for ( unsigned long phase = 0; phase < sizeof( letters ); ++phase )
+  {
+    Sketch sketch;
+    sketch.type( "#S1PARIS PARIS PARIS\n" );
+    sketch.run( settleTime + phase );
+
+    Morse::MorseCodeElement elements[ Morse::SEQUENCE_LENGTH ];
+    Morse::asciiToMorse( letters[ phase ], elements );
+    unsigned int length = 0;
+    while ( length < Morse::SEQUENCE_LENGTH && elements[ length ] != Morse::SPACE )
+    {
+      ++length;
+    }
+    ++length;  // The end of the character.
+
+    std::string message = "#S2";
+    message.append( MacroStore::SYMBOL_CAPACITY / length, letters[ phase ] );
+    sketch.type( "#P1\n" + message + "\n" );
+    sketch.run( 4 * MacroStore::SLOT_LENGTH );
+    check( sketch.player.playing() && sketch.macros.symbolCount( 2 ) == MacroStore::SYMBOL_CAPACITY / length * length,
+           "slot 2 written while slot 1 plays, phase %lu", phase );
+    check( sketch.stalls == 0, "playback waited for EEPROM %lu times, phase %lu", sketch.stalls, phase );
+  }
+}
+
+int main()
+{
+  Check check( "macrocheck" );
+
+  checkLineEndings( check );
+  checkCommands( check );
+  checkRepeat( check );
+  checkStoreOver( check );
+  checkWrap( check );
+  checkNoWait( check );
+
+  return check.finish();
+}
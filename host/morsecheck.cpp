@@ -0,0 +1,123 @@
+/*
+  morsecheck.cpp
+
+  Checks the Morse code lookups (morse.h): every letter and digit against its code written out by hand,
+  the round trip through both lookups, codewords that aren't in the table, and the receive thresholds
+  against the durations the sketch sends.
+
+  Usage: morsecheck
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <string>
+#include "check.h"
+#include "morse.h"
+
+// Constants
+
+// Every character the sketch can send, and its code in dot/dash notation.
+static const char * const codes[][ 2 ] =
+{
+  { "A", ".-" },    { "B", "-..." },  { "C", "-.-." },  { "D", "-.." },   { "E", "." },     { "F", "..-." },
+  { "G", "--." },   { "H", "...." },  { "I", ".." },    { "J", ".---" },  { "K", "-.-" },   { "L", ".-.." },
+  { "M", "--" },    { "N", "-." },    { "O", "---" },   { "P", ".--." },  { "Q", "--.-" },  { "R", ".-." },
+  { "S", "..." },   { "T", "-" },     { "U", "..-" },   { "V", "...-" },  { "W", ".--" },   { "X", "-..-" },
+  { "Y", "-.--" },  { "Z", "--.." },
+  { "0", "-----" }, { "1", ".----" }, { "2", "..---" }, { "3", "...--" }, { "4", "....-" },
+  { "5", "....." }, { "6", "-...." }, { "7", "--..." }, { "8", "---.." }, { "9", "----." },
+};
+
+// notation()
+// Arguments:
+//   sequence - Morse code, SPACE filled.
+// Returns:
+//   The code in dot/dash notation.
+static std::string notation( const Morse::MorseCodeElement * const sequence )
+{
+  std::string text;
+  for ( unsigned int idx = 0; idx < Morse::SEQUENCE_LENGTH && sequence[ idx ] != Morse::SPACE; ++idx )
+  {
+    text += sequence[ idx ] == Morse::DOT ? '.' : '-';
+  }
+  return text;
+}
+
+// sequence()
+// Arguments:
+//   text - Dot/dash notation, no longer than SEQUENCE_LENGTH.
+//   sequence - Filled with the code, SPACE filled.
+static void sequence( const std::string & text, Morse::MorseCodeElement * const sequence )
+{
+  for ( unsigned int idx = 0; idx < Morse::SEQUENCE_LENGTH; ++idx )
+  {
+    sequence[ idx ] = idx >= text.size() ? Morse::SPACE : text[ idx ] == '.' ? Morse::DOT : Morse::DASH;
+  }
+}
+
+static void checkLookups( Check & check )
+{
+  for ( unsigned int idx = 0; idx < sizeof( codes ) / sizeof( codes[ 0 ] ); ++idx )
+  {
+    const char character = codes[ idx ][ 0 ][ 0 ];
+    const std::string code = codes[ idx ][ 1 ];
+
+    Morse::MorseCodeElement elements[ Morse::SEQUENCE_LENGTH ];
+    check( Morse::asciiToMorse( character, elements ) && notation( elements ) == code, "'%c' is sent as \"%s\", not \"%s\"",
+           character, notation( elements ).c_str(), code.c_str() );
+    if ( character >= 'A' && character <= 'Z' )
+    {
+      Morse::asciiToMorse( character - 'A' + 'a', elements );
+      check( notation( elements ) == code, "'%c' is sent as \"%s\", not \"%s\"", character - 'A' + 'a',
+             notation( elements ).c_str(), code.c_str() );
+    }
+
+    sequence( code, elements );
+    check( Morse::morseToAscii( elements ) == character, "\"%s\" is received as '%c', not '%c'", code.c_str(),
+           Morse::morseToAscii( elements ), character );
+  }
+
+  // Codes that aren't in the table.
+  const char * const unknown[] = { "..--", ".-.-", "---.", "----", "" };
+  for ( unsigned int idx = 0; idx < sizeof( unknown ) / sizeof( unknown[ 0 ] ); ++idx )
+  {
+    Morse::MorseCodeElement elements[ Morse::SEQUENCE_LENGTH ];
+    sequence( unknown[ idx ], elements );
+    check( Morse::morseToAscii( elements ) == '?', "\"%s\" is received as '%c', not '?'", unknown[ idx ],
+           Morse::morseToAscii( elements ) );
+  }
+
+  Morse::MorseCodeElement elements[ Morse::SEQUENCE_LENGTH ];
+  check( !Morse::asciiToMorse( '?', elements ) && !Morse::asciiToMorse( ' ', elements ) &&
+         !Morse::asciiToMorse( '/', elements ) && !Morse::asciiToMorse( ':', elements ),
+         "characters outside A to Z and 0 to 9 have no code" );
+}
+
+static void checkThresholds( Check & check )
+{
+  // Marks.
+  check( Morse::classifyMark( Morse::DOT_DURATION ) == Morse::DOT, "a DOT is received as a DOT" );
+  check( Morse::classifyMark( Morse::DASH_DURATION ) == Morse::DASH, "a DASH is received as a DASH" );
+  check( Morse::classifyMark( Morse::NOISE_THRESHOLD - 1 ) == Morse::SPACE, "a mark under half a DOT is noise" );
+
+  // Gaps, as AsciiToMorse leaves them.
+  check( Morse::KEY_SPACE_DURATION < Morse::LETTER_SPACE_THRESHOLD, "the space between elements is not a letter space" );
+  check( Morse::LETTER_SPACE_DURATION >= Morse::LETTER_SPACE_THRESHOLD, "a letter space ends the letter" );
+  check( Morse::LETTER_SPACE_DURATION < Morse::WORD_SPACE_THRESHOLD, "a letter space is not a word space" );
+  check( Morse::LETTER_SPACE_DURATION + Morse::WORD_SPACE_DURATION - Morse::KEY_SPACE_DURATION >= Morse::WORD_SPACE_THRESHOLD,
+         "the gap for a SPACE ends the word" );
+}
+
+int main()
+{
+  Check check( "morsecheck" );
+
+  checkLookups( check );
+  checkThresholds( check );
+
+  return check.finish();
+}
@@ -0,0 +1,226 @@
+/*
+  morseclient.cpp
+
+  Client for morsed, the local Morse code service.
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "morseclient.h"
+
+// Constants
+static const size_t readLength = 1 << 16;   // Bytes read at a time.
+
+MorseClient::MorseClient() :
+  fd( -1 ),
+  nextId( 0 ),
+  lastStatus( Frame::OK ),
+  inputStart( 0 )
+{
+}
+
+MorseClient::~MorseClient()
+{
+  close();
+}
+
+bool MorseClient::connect( const char * const path )
+{
+  close();
+
+  sockaddr_un address;
+  std::memset( &address, 0, sizeof( address ) );
+  address.sun_family = AF_UNIX;
+  if ( std::strlen( path ) >= sizeof( address.sun_path ) )
+  {
+    errno = ENAMETOOLONG;
+    return false;
+  }
+  std::strcpy( address.sun_path, path );
+
+  fd = ::socket( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0 );
+  if ( fd < 0 )
+  {
+    return false;
+  }
+  if ( ::connect( fd, reinterpret_cast< sockaddr * >( &address ), sizeof( address ) ) != 0 )
+  {
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+void MorseClient::close()
+{
+  if ( fd >= 0 )
+  {
+    ::close( fd );
+    fd = -1;
+  }
+
+  output.clear();
+  input.clear();
+  inputStart = 0;
+}
+
+bool MorseClient::encode( const std::string & text, std::string & notation )
+{
+  if ( !call( Frame::ENCODE, text.data(), text.size() ) )
+  {
+    return false;
+  }
+
+  notation.assign( reply.begin(), reply.end() );
+  return true;
+}
+
+bool MorseClient::decode( const std::string & notation, std::string & text )
+{
+  if ( !call( Frame::DECODE, notation.data(), notation.size() ) )
+  {
+    return false;
+  }
+
+  text.assign( reply.begin(), reply.end() );
+  return true;
+}
+
+bool MorseClient::render( const std::string & text, std::vector< unsigned char > & pcm )
+{
+  if ( !call( Frame::RENDER, text.data(), text.size() ) )
+  {
+    return false;
+  }
+
+  pcm.swap( reply );
+  return true;
+}
+
+bool MorseClient::decodeTiming( const std::vector< unsigned long > & runs, std::string & text )
+{
+  std::vector< unsigned char > payload( 4 * runs.size() );
+  for ( size_t idx = 0; idx < runs.size(); ++idx )
+  {
+    Frame::putUint32( static_cast< uint32_t >( runs[ idx ] ), payload.data() + 4 * idx );
+  }
+
+  if ( !call( Frame::DECODE_TIMING, payload.data(), payload.size() ) )
+  {
+    return false;
+  }
+
+  text.assign( reply.begin(), reply.end() );
+  return true;
+}
+
+Frame::Status MorseClient::status() const
+{
+  return lastStatus;
+}
+
+uint32_t MorseClient::send( const Frame::Op op, const void * const payload, const size_t length )
+{
+  Frame::Header header;
+  header.length = static_cast< uint32_t >( length );
+  header.id = nextId++;
+  header.op = static_cast< unsigned char >( op );
+  header.status = Frame::OK;
+
+  const size_t start = output.size();
+  output.resize( start + Frame::HEADER_LENGTH );
+  Frame::putHeader( header, output.data() + start );
+  output.insert( output.end(), static_cast< const unsigned char * >( payload ),
+                 static_cast< const unsigned char * >( payload ) + length );
+
+  return header.id;
+}
+
+bool MorseClient::flush()
+{
+  size_t sent = 0;
+  while ( sent < output.size() )
+  {
+    const ssize_t length = ::send( fd, output.data() + sent, output.size() - sent, MSG_NOSIGNAL );
+    if ( length < 0 && errno == EINTR )
+    {
+      continue;
+    }
+    if ( length <= 0 )
+    {
+      return false;
+    }
+    sent += length;
+  }
+
+  output.clear();
+  return true;
+}
+
+bool MorseClient::ready() const
+{
+  const size_t available = input.size() - inputStart;
+  return available >= Frame::HEADER_LENGTH &&
+         available - Frame::HEADER_LENGTH >= Frame::getHeader( input.data() + inputStart ).length;
+}
+
+bool MorseClient::receive( Frame::Header & header, std::vector< unsigned char > & payload )
+{
+  while ( !ready() )
+  {
+    if ( fd < 0 )
+    {
+      return false;
+    }
+
+    // Make room at the end, first by dropping what's been returned.
+    if ( inputStart != 0 )
+    {
+      input.erase( input.begin(), input.begin() + inputStart );
+      inputStart = 0;
+    }
+    const size_t used = input.size();
+    input.resize( used + readLength );
+    const ssize_t length = ::recv( fd, input.data() + used, readLength, 0 );
+    input.resize( used + ( length > 0 ? length : 0 ) );
+
+    if ( length < 0 && errno == EINTR )
+    {
+      continue;
+    }
+    if ( length <= 0 )
+    {
+      return false;
+    }
+  }
+
+  header = Frame::getHeader( input.data() + inputStart );
+  const unsigned char * const start = input.data() + inputStart + Frame::HEADER_LENGTH;
+  payload.assign( start, start + header.length );
+  inputStart += Frame::HEADER_LENGTH + header.length;
+  lastStatus = static_cast< Frame::Status >( header.status );
+
+  return true;
+}
+
+bool MorseClient::call( const Frame::Op op, const void * const payload, const size_t length )
+{
+  Frame::Header header;
+  const uint32_t id = send( op, payload, length );
+  if ( !flush() || !receive( header, reply ) || header.id != id )
+  {
+    return false;
+  }
+
+  return header.status == Frame::OK;
+}
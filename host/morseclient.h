@@ -0,0 +1,103 @@
+/*
+  morseclient.h
+
+  Client for morsed, the local Morse code service (see morsed.cpp and frame.h). The simple calls send
+  one request and wait for its reply. For throughput, send() any number of requests, flush() them in
+  one write, and receive() the replies in the order they were sent. Keep what's in flight bounded,
+  since the service stops reading a connection whose replies aren't being read.
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#ifndef MORSECLIENT_H
+#define MORSECLIENT_H
+
+#include <string>
+#include <vector>
+#include "frame.h"
+
+class MorseClient
+{
+  public:
+  // Constructor
+  MorseClient();
+
+  // Destructor
+  ~MorseClient();
+
+  // connect()
+  // Arguments:
+  //   path - the service's socket.
+  // Returns:
+  //   false if it couldn't connect.
+  bool connect( const char * const path );
+
+  // close()
+  // Closes the connection. Requests not yet received are lost.
+  void close();
+
+  // encode(), decode(), render(), decodeTiming()
+  // Arguments:
+  //   The request payload, as frame.h describes for the op, then storage for the reply payload.
+  // Returns:
+  //   false if the connection failed, or the service didn't return OK. status() says which.
+  bool encode( const std::string & text, std::string & notation );
+  bool decode( const std::string & notation, std::string & text );
+  bool render( const std::string & text, std::vector< unsigned char > & pcm );
+  bool decodeTiming( const std::vector< unsigned long > & runs, std::string & text );
+
+  // status()
+  // Returns:
+  //   Frame::Status of the last reply received.
+  Frame::Status status() const;
+
+  // send()
+  // Arguments:
+  //   op - Frame::Op of the request.
+  //   payload - request payload.
+  //   length - payload bytes.
+  // Returns:
+  //   The request's id, which its reply carries. Queues the request for flush().
+  uint32_t send( const Frame::Op op, const void * const payload, const size_t length );
+
+  // flush()
+  // Returns:
+  //   false if the connection failed. Writes all the requests queued by send().
+  bool flush();
+
+  // receive()
+  // Arguments:
+  //   header - storage for the next reply's header.
+  //   payload - storage for its payload.
+  // Returns:
+  //   false if the connection failed or closed. Waits for the reply if it hasn't arrived.
+  bool receive( Frame::Header & header, std::vector< unsigned char > & payload );
+
+  // ready()
+  // Returns:
+  //   true if receive() has a reply to return without waiting.
+  bool ready() const;
+
+  private:
+  int                          fd;
+  uint32_t                     nextId;
+  Frame::Status                lastStatus;
+  std::vector< unsigned char > output;      // Requests not yet flushed.
+  std::vector< unsigned char > input;       // Bytes received. From inputStart on, not yet returned.
+  size_t                       inputStart;
+  std::vector< unsigned char > reply;       // Payload of the simple calls' replies.
+
+  // call()
+  // Sends one request and receives its reply into reply.
+  bool call( const Frame::Op op, const void * const payload, const size_t length );
+
+  // Not copyable: the connection belongs to one client.
+  MorseClient( const MorseClient & );
+  MorseClient & operator=( const MorseClient & );
+};
+
+#endif
@@ -0,0 +1,503 @@
+/*
+  morsed.cpp
+
+  Local Morse code service. Serves encode, decode, render and timing decode requests (see frame.h)
+  over a Unix domain socket, so every process on the host shares one copy of the codec, already warmed
+  up, rather than each embedding its own.
+
+  One thread runs an epoll loop over the listening socket and every connection. Each wakeup reads all
+  that every ready connection has sent, serves the complete requests found, and sends their replies
+  with one write per connection. Clients that pipeline small requests get them served in batches, with
+  system calls per batch rather than per request. A batch stops at serveLimit requests or replyLimit
+  bytes of replies, so one busy client can't hold the others up. Connections with requests left over go
+  round again, without waiting for the socket, after the others have had their turn. Each connection keeps its buffers for
+  as long as it's open, and the service keeps its decoders, so a request allocates nothing once they
+  have grown to fit. A connection with too much unsent stops being read until it catches up.
+
+  Runs until interrupted, then reports what it served on standard error. Linux only.
+
+  Usage: morsed [-s socket] [-r rate] [-f frequency]
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "frame.h"
+#include "service.h"
+
+// Typedefs
+struct Connection
+{
+  int                          fd;
+  std::vector< unsigned char > input;        // Bytes received, up to inputEnd. From inputStart on, not yet served.
+  size_t                       inputStart;
+  size_t                       inputEnd;
+  std::vector< unsigned char > output;       // Replies. From outputStart on, not yet sent.
+  size_t                       outputStart;
+  uint32_t                     events;       // What epoll watches for.
+  bool                         closing;      // Close once the output is sent.
+  bool                         backlogged;   // Has complete requests left over from its last batch.
+};
+
+struct Statistics
+{
+  unsigned long long requests[ Frame::DECODE_TIMING + 1 ];  // By op. Unknown ops count as 0.
+  unsigned long long batches;                               // Times a connection had requests served.
+  unsigned long long bytesIn;
+  unsigned long long bytesOut;
+  unsigned long long connections;
+};
+
+// Constants
+static const char * const defaultSocket = "/tmp/morsed.sock";
+static const size_t readLength = 1 << 16;               // Bytes read at a time.
+static const size_t inputLimit = 1 << 20;               // Unserved bytes that stop a connection being read.
+static const size_t outputLimit = Frame::MAX_REPLY;     // Unsent bytes that stop requests being served.
+static const unsigned int serveLimit = 256;             // Requests in one batch.
+static const size_t replyLimit = 1 << 20;               // Reply bytes that end a batch.
+static const int maxEvents = 64;
+
+static volatile std::sig_atomic_t stopping = 0;
+
+static void stop( int )
+{
+  stopping = 1;
+}
+
+// wanted()
+// Arguments:
+//   connection - Connection to read from.
+// Returns:
+//   How many unserved bytes to read up to: inputLimit, or all of the next request if it's longer.
+static size_t wanted( const Connection & connection )
+{
+  if ( connection.inputEnd - connection.inputStart < Frame::HEADER_LENGTH )
+  {
+    return inputLimit;
+  }
+
+  const size_t length = Frame::HEADER_LENGTH + Frame::getHeader( connection.input.data() + connection.inputStart ).length;
+  return length > inputLimit && length <= Frame::HEADER_LENGTH + Frame::MAX_PAYLOAD ? length : inputLimit;
+}
+
+// receive()
+// Arguments:
+//   connection - Connection the socket says is readable.
+//   statistics - Updated.
+// Reads all there is, up to what's wanted(). Marks the connection closing at end of file or on an error.
+static void receive( Connection & connection, Statistics & statistics )
+{
+  while ( connection.inputEnd - connection.inputStart < wanted( connection ) )
+  {
+    if ( connection.input.size() - connection.inputEnd < readLength )
+    {
+      connection.input.resize( connection.inputEnd + readLength );
+    }
+
+    const ssize_t length = ::recv( connection.fd, connection.input.data() + connection.inputEnd,
+                                   connection.input.size() - connection.inputEnd, 0 );
+    if ( length > 0 )
+    {
+      connection.inputEnd += length;
+      statistics.bytesIn += length;
+      continue;
+    }
+    if ( length < 0 && errno == EINTR )
+    {
+      continue;
+    }
+    if ( length == 0 || ( errno != EAGAIN && errno != EWOULDBLOCK ) )
+    {
+      connection.closing = true;
+    }
+    return;
+  }
+}
+
+// serve()
+// Arguments:
+//   connection - Connection to serve.
+//   service - Does the work.
+//   statistics - Updated.
+// Returns:
+//   true if the batch ended with requests left over, and the connection needs serving again.
+// Serves a batch of the complete requests received, and queues the replies, until the batch is full or
+// there's too much unsent.
+static bool serve( Connection & connection, MorseService & service, Statistics & statistics )
+{
+  const size_t batchStart = connection.output.size();
+  unsigned int served = 0;
+
+  while ( connection.inputEnd - connection.inputStart >= Frame::HEADER_LENGTH &&
+          connection.output.size() - connection.outputStart < outputLimit )
+  {
+    if ( served == serveLimit || connection.output.size() - batchStart >= replyLimit )
+    {
+      break;
+    }
+
+    const unsigned char * const request = connection.input.data() + connection.inputStart;
+    const Frame::Header header = Frame::getHeader( request );
+
+    Frame::Header reply = header;
+    const size_t replyStart = connection.output.size();
+    connection.output.resize( replyStart + Frame::HEADER_LENGTH );
+
+    if ( header.length > Frame::MAX_PAYLOAD )
+    {
+      // There's no telling where the next request starts. Say why, and hang up.
+      reply.length = 0;
+      reply.status = Frame::BAD_REQUEST;
+      Frame::putHeader( reply, connection.output.data() + replyStart );
+      connection.inputStart = connection.inputEnd;
+      connection.closing = true;
+      break;
+    }
+    if ( connection.inputEnd - connection.inputStart < Frame::HEADER_LENGTH + header.length )
+    {
+      connection.output.resize( replyStart );
+      break;
+    }
+
+    reply.status = service.handle( header.op, request + Frame::HEADER_LENGTH, header.length, connection.output );
+    reply.length = static_cast< uint32_t >( connection.output.size() - replyStart - Frame::HEADER_LENGTH );
+    Frame::putHeader( reply, connection.output.data() + replyStart );
+
+    connection.inputStart += Frame::HEADER_LENGTH + header.length;
+    ++statistics.requests[ header.op <= Frame::DECODE_TIMING ? header.op : 0 ];
+    ++served;
+  }
+
+  // Move what's left to the front, for the rest of it to be read after it.
+  if ( connection.inputStart != 0 )
+  {
+    std::memmove( connection.input.data(), connection.input.data() + connection.inputStart,
+                  connection.inputEnd - connection.inputStart );
+    connection.inputEnd -= connection.inputStart;
+    connection.inputStart = 0;
+  }
+
+  if ( served != 0 )
+  {
+    ++statistics.batches;
+  }
+
+  // Only a full batch leaves requests for next time. Otherwise the rest of them hasn't arrived, or
+  // there's too much unsent, and EPOLLOUT says when there's room.
+  const bool full = served == serveLimit || connection.output.size() - batchStart >= replyLimit;
+  return full && connection.output.size() - connection.outputStart < outputLimit &&
+         connection.inputEnd >= Frame::HEADER_LENGTH &&
+         connection.inputEnd >= Frame::HEADER_LENGTH + Frame::getHeader( connection.input.data() ).length;
+}
+
+// send()
+// Arguments:
+//   connection - Connection with replies to send.
+//   statistics - Updated.
+// Sends as much as the socket takes. Marks the connection closing on an error.
+static void send( Connection & connection, Statistics & statistics )
+{
+  while ( connection.outputStart < connection.output.size() )
+  {
+    const ssize_t length = ::send( connection.fd, connection.output.data() + connection.outputStart,
+                                   connection.output.size() - connection.outputStart, MSG_NOSIGNAL );
+    if ( length < 0 )
+    {
+      if ( errno == EINTR )
+      {
+        continue;
+      }
+      if ( errno != EAGAIN && errno != EWOULDBLOCK )
+      {
+        connection.closing = true;
+        connection.outputStart = connection.output.size();
+      }
+      else if ( connection.outputStart > connection.output.size() / 2 )
+      {
+        // Don't let a client that's always behind grow the buffer without end.
+        connection.output.erase( connection.output.begin(), connection.output.begin() + connection.outputStart );
+        connection.outputStart = 0;
+      }
+      return;
+    }
+
+    connection.outputStart += length;
+    statistics.bytesOut += length;
+  }
+
+  connection.output.clear();
+  connection.outputStart = 0;
+}
+
+// update()
+// Arguments:
+//   epoll - Event loop.
+//   connection - Connection just served. Deleted if it's done with.
+// Closes the connection once it's closing and its replies are sent, otherwise watches for what it
+// needs next. A backlogged connection is kept, to be served again.
+static void update( const int epoll, Connection * const connection )
+{
+  const size_t unsent = connection->output.size() - connection->outputStart;
+
+  if ( connection->closing && unsent == 0 && !connection->backlogged )
+  {
+    ::close( connection->fd );
+    delete connection;
+    return;
+  }
+
+  const bool full = connection->inputEnd - connection->inputStart >= wanted( *connection ) || unsent >= outputLimit;
+  uint32_t events = 0;
+  if ( !connection->closing && !full )
+  {
+    events |= EPOLLIN;
+  }
+  if ( unsent != 0 )
+  {
+    events |= EPOLLOUT;
+  }
+  if ( events != connection->events )
+  {
+    epoll_event event;
+    event.events = events;
+    event.data.ptr = connection;
+    ::epoll_ctl( epoll, EPOLL_CTL_MOD, connection->fd, &event );
+    connection->events = events;
+  }
+}
+
+// accept()
+// Arguments:
+//   epoll - Event loop.
+//   listener - Listening socket.
+//   statistics - Updated.
+// Accepts every waiting connection.
+static void accept( const int epoll, const int listener, Statistics & statistics )
+{
+  for ( ;; )
+  {
+    const int fd = ::accept4( listener, 0, 0, SOCK_NONBLOCK | SOCK_CLOEXEC );
+    if ( fd < 0 )
+    {
+      if ( errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR )
+      {
+        std::perror( "morsed: accept" );
+      }
+      if ( errno != EINTR )
+      {
+        return;
+      }
+      continue;
+    }
+
+    Connection * const connection = new Connection();
+    connection->fd = fd;
+    connection->inputStart = 0;
+    connection->inputEnd = 0;
+    connection->outputStart = 0;
+    connection->events = EPOLLIN;
+    connection->closing = false;
+    connection->backlogged = false;
+
+    epoll_event event;
+    event.events = connection->events;
+    event.data.ptr = connection;
+    ::epoll_ctl( epoll, EPOLL_CTL_ADD, fd, &event );
+    ++statistics.connections;
+  }
+}
+
+// listen()
+// Arguments:
+//   path - Socket to listen on.
+// Returns:
+//   The listening socket, or -1. Replaces a socket left behind by a service that's gone, but not one
+//   that's still answering.
+static int listen( const char * const path )
+{
+  sockaddr_un address;
+  std::memset( &address, 0, sizeof( address ) );
+  address.sun_family = AF_UNIX;
+  if ( std::strlen( path ) >= sizeof( address.sun_path ) )
+  {
+    std::fprintf( stderr, "morsed: %s: path too long\n", path );
+    return -1;
+  }
+  std::strcpy( address.sun_path, path );
+
+  const int probe = ::socket( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0 );
+  if ( probe >= 0 && ::connect( probe, reinterpret_cast< sockaddr * >( &address ), sizeof( address ) ) == 0 )
+  {
+    std::fprintf( stderr, "morsed: %s: already being served\n", path );
+    ::close( probe );
+    return -1;
+  }
+  if ( probe >= 0 )
+  {
+    ::close( probe );
+  }
+  ::unlink( path );
+
+  const int listener = ::socket( AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0 );
+  if ( listener < 0 ||
+       ::bind( listener, reinterpret_cast< sockaddr * >( &address ), sizeof( address ) ) != 0 ||
+       ::listen( listener, SOMAXCONN ) != 0 )
+  {
+    std::perror( path );
+    if ( listener >= 0 )
+    {
+      ::close( listener );
+    }
+    return -1;
+  }
+
+  return listener;
+}
+
+static int usage()
+{
+  std::fprintf( stderr,
+                "usage: morsed [-s socket] [-r rate] [-f frequency]\n"
+                "  Serves Morse code requests (see host/frame.h) until interrupted.\n"
+                "  Defaults: -s %s -r 8000 -f 600.\n", defaultSocket );
+  return 2;
+}
+
+int main( int argc, char * argv[] )
+{
+  const char * path = defaultSocket;
+  unsigned int sampleRate = 8000;
+  double frequency = 600.0;
+
+  for ( int arg = 1; arg < argc; ++arg )
+  {
+    if ( argv[ arg ][ 0 ] != '-' || argv[ arg ][ 1 ] == 0 || argv[ arg ][ 2 ] != 0 || arg + 1 >= argc )
+    {
+      return usage();
+    }
+
+    const char * const value = argv[ ++arg ];
+    switch ( argv[ arg - 1 ][ 1 ] )
+    {
+      case 's':
+        path = value;
+        break;
+      case 'r':
+        sampleRate = static_cast< unsigned int >( std::strtoul( value, 0, 10 ) );
+        break;
+      case 'f':
+        frequency = std::strtod( value, 0 );
+        break;
+      default:
+        return usage();
+    }
+  }
+  if ( sampleRate == 0 || frequency <= 0.0 || frequency >= sampleRate / 2.0 )
+  {
+    return usage();
+  }
+
+  const int listener = listen( path );
+  if ( listener < 0 )
+  {
+    return 1;
+  }
+
+  struct sigaction action;
+  std::memset( &action, 0, sizeof( action ) );
+  action.sa_handler = stop;
+  ::sigaction( SIGINT, &action, 0 );
+  ::sigaction( SIGTERM, &action, 0 );
+
+  const int epoll = ::epoll_create1( EPOLL_CLOEXEC );
+  epoll_event event;
+  event.events = EPOLLIN;
+  event.data.ptr = 0;
+  ::epoll_ctl( epoll, EPOLL_CTL_ADD, listener, &event );
+
+  MorseService service( sampleRate, frequency );
+  Statistics statistics;
+  std::memset( &statistics, 0, sizeof( statistics ) );
+  std::vector< epoll_event > events( maxEvents );
+  std::vector< Connection * > ready;
+  std::vector< Connection * > backlog;    // Connections to serve again, whether or not they're ready.
+
+  while ( !stopping )
+  {
+    // Don't sleep while there are requests waiting.
+    const int count = ::epoll_wait( epoll, events.data(), maxEvents, backlog.empty() ? -1 : 0 );
+    if ( count < 0 )
+    {
+      if ( errno == EINTR )
+      {
+        continue;
+      }
+      std::perror( "morsed: epoll_wait" );
+      break;
+    }
+
+    // Read everything first, so requests that arrived together are served together.
+    for ( int idx = 0; idx < count; ++idx )
+    {
+      Connection * const connection = static_cast< Connection * >( events[ idx ].data.ptr );
+      if ( connection == 0 )
+      {
+        accept( epoll, listener, statistics );
+      }
+      else if ( events[ idx ].events & ( EPOLLIN | EPOLLHUP | EPOLLERR ) )
+      {
+        receive( *connection, statistics );
+      }
+    }
+
+    // Then serve a batch from each, going round the ready connections before the backlog, once each.
+    ready.clear();
+    for ( int idx = 0; idx < count; ++idx )
+    {
+      Connection * const connection = static_cast< Connection * >( events[ idx ].data.ptr );
+      if ( connection != 0 && !connection->backlogged )
+      {
+        ready.push_back( connection );
+      }
+    }
+    ready.insert( ready.end(), backlog.begin(), backlog.end() );
+    backlog.clear();
+
+    for ( size_t idx = 0; idx < ready.size(); ++idx )
+    {
+      Connection * const connection = ready[ idx ];
+      connection->backlogged = serve( *connection, service, statistics );
+      if ( connection->backlogged )
+      {
+        backlog.push_back( connection );
+      }
+      send( *connection, statistics );
+      update( epoll, connection );
+    }
+  }
+
+  ::close( listener );
+  ::unlink( path );
+
+  std::fprintf( stderr, "morsed: %llu requests (encode %llu, decode %llu, render %llu, timing %llu, bad %llu) "
+                "in %llu batches over %llu connections, %llu bytes in, %llu bytes out\n",
+                statistics.requests[ Frame::ENCODE ] + statistics.requests[ Frame::DECODE ] +
+                statistics.requests[ Frame::RENDER ] + statistics.requests[ Frame::DECODE_TIMING ] + statistics.requests[ 0 ],
+                statistics.requests[ Frame::ENCODE ], statistics.requests[ Frame::DECODE ],
+                statistics.requests[ Frame::RENDER ], statistics.requests[ Frame::DECODE_TIMING ], statistics.requests[ 0 ],
+                statistics.batches, statistics.connections, statistics.bytesIn, statistics.bytesOut );
+  return 0;
+}
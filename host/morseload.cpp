@@ -0,0 +1,306 @@
+/*
+  morseload.cpp
+
+  Load generator for morsed, the local Morse code service. Opens a number of connections, each on its
+  own thread, and keeps a number of requests in flight on each until it has sent its share. Every
+  request carries the same message, so every reply has to match the first; any that doesn't, or that
+  isn't OK, counts as an error. Reports throughput, and the latency of each request from just before
+  it was flushed to when its reply arrived.
+
+  Usage: morseload [-s socket] [-o encode|decode|render|timing] [-c connections] [-d depth]
+                   [-n requests] [-m message]
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+#include "keying.h"
+#include "morseclient.h"
+
+// Typedefs
+typedef std::chrono::steady_clock Clock;
+
+struct Options
+{
+  const char *  path;
+  Frame::Op     op;
+  unsigned long connections;
+  unsigned long depth;
+  unsigned long requests;       // Per connection.
+  std::string   message;
+};
+
+// What one connection did.
+struct Result
+{
+  std::vector< double > latencies;  // Microseconds.
+  unsigned long         errors;
+  unsigned long long    bytesOut;   // Request payloads.
+  unsigned long long    bytesIn;    // Reply payloads.
+  bool                  failed;     // The connection failed.
+};
+
+// Constants
+static const char * const defaultSocket = "/tmp/morsed.sock";
+static const char * const defaultMessage = "THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG 0123456789";
+
+// payloadFor()
+// Arguments:
+//   options - The op and message.
+//   client - Connected client, to encode the message into notation for DECODE.
+//   payload - Storage for the request payload.
+// Returns:
+//   false if the payload couldn't be made.
+static bool payloadFor( const Options & options, MorseClient & client, std::vector< unsigned char > & payload )
+{
+  switch ( options.op )
+  {
+    case Frame::DECODE:
+    {
+      std::string notation;
+      if ( !client.encode( options.message, notation ) )
+      {
+        return false;
+      }
+      payload.assign( notation.begin(), notation.end() );
+      return true;
+    }
+    case Frame::DECODE_TIMING:
+    {
+      KeyingSchedule schedule;
+      std::vector< unsigned char > symbols;
+      std::vector< unsigned long > runs;
+      for ( size_t idx = 0; idx < options.message.size(); ++idx )
+      {
+        schedule.addCharacter( options.message[ idx ], symbols, runs );
+      }
+      schedule.finish( runs );
+
+      payload.resize( 4 * runs.size() );
+      for ( size_t idx = 0; idx < runs.size(); ++idx )
+      {
+        Frame::putUint32( static_cast< uint32_t >( runs[ idx ] ), payload.data() + 4 * idx );
+      }
+      return true;
+    }
+    default:
+      payload.assign( options.message.begin(), options.message.end() );
+      return true;
+  }
+}
+
+// run()
+// Arguments:
+//   options - What to send.
+//   result - Storage for what happened.
+// Runs one connection's share of the load.
+static void run( const Options & options, Result & result )
+{
+  MorseClient client;
+  std::vector< unsigned char > payload;
+  if ( !client.connect( options.path ) || !payloadFor( options, client, payload ) )
+  {
+    result.failed = true;
+    return;
+  }
+
+  std::deque< Clock::time_point > flushed;   // When each request in flight was flushed, oldest first.
+  std::vector< unsigned char > expected;
+  std::vector< unsigned char > reply;
+  Frame::Header header;
+  unsigned long sent = 0;
+  unsigned long received = 0;
+  result.latencies.reserve( options.requests );
+
+  while ( received < options.requests )
+  {
+    // Top up what's in flight, all in one write.
+    const unsigned long topUp = std::min( options.depth - ( sent - received ), options.requests - sent );
+    for ( unsigned long count = 0; count < topUp; ++count )
+    {
+      client.send( options.op, payload.data(), payload.size() );
+      result.bytesOut += payload.size();
+    }
+    if ( topUp != 0 )
+    {
+      const Clock::time_point now = Clock::now();
+      if ( !client.flush() )
+      {
+        result.failed = true;
+        return;
+      }
+      flushed.insert( flushed.end(), topUp, now );
+      sent += topUp;
+    }
+
+    // Wait for one reply, then take whatever else came with it.
+    do
+    {
+      if ( !client.receive( header, reply ) )
+      {
+        result.failed = true;
+        return;
+      }
+
+      const Clock::time_point now = Clock::now();
+      result.latencies.push_back( std::chrono::duration< double, std::micro >( now - flushed.front() ).count() );
+      flushed.pop_front();
+      result.bytesIn += reply.size();
+      ++received;
+
+      if ( received == 1 )
+      {
+        expected = reply;
+      }
+      if ( header.status != Frame::OK || reply != expected )
+      {
+        ++result.errors;
+      }
+    }
+    while ( client.ready() );
+  }
+}
+
+// parseOp()
+// Returns false if name isn't an op.
+static bool parseOp( const char * const name, Frame::Op & op )
+{
+  static const char * const names[] = { "encode", "decode", "render", "timing" };
+  static const Frame::Op ops[] = { Frame::ENCODE, Frame::DECODE, Frame::RENDER, Frame::DECODE_TIMING };
+
+  for ( unsigned int idx = 0; idx < sizeof( names ) / sizeof( names[ 0 ] ); ++idx )
+  {
+    if ( std::strcmp( name, names[ idx ] ) == 0 )
+    {
+      op = ops[ idx ];
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// percentile()
+// Arguments:
+//   sorted - Values in ascending order. Not empty.
+//   fraction - 0 to 1.
+static double percentile( const std::vector< double > & sorted, const double fraction )
+{
+  return sorted[ static_cast< size_t >( fraction * ( sorted.size() - 1 ) ) ];
+}
+
+static int usage()
+{
+  std::fprintf( stderr,
+                "usage: morseload [-s socket] [-o encode|decode|render|timing] [-c connections] [-d depth]\n"
+                "                 [-n requests] [-m message]\n"
+                "  Sends requests to morsed, and reports throughput and latency. -n is per connection.\n"
+                "  Defaults: -s %s -o decode -c 4 -d 16 -n 100000 -m \"%s\".\n",
+                defaultSocket, defaultMessage );
+  return 2;
+}
+
+int main( int argc, char * argv[] )
+{
+  Options options = { defaultSocket, Frame::DECODE, 4, 16, 100000, defaultMessage };
+
+  for ( int arg = 1; arg < argc; ++arg )
+  {
+    if ( argv[ arg ][ 0 ] != '-' || argv[ arg ][ 1 ] == 0 || argv[ arg ][ 2 ] != 0 || arg + 1 >= argc )
+    {
+      return usage();
+    }
+
+    const char * const value = argv[ ++arg ];
+    switch ( argv[ arg - 1 ][ 1 ] )
+    {
+      case 's':
+        options.path = value;
+        break;
+      case 'o':
+        if ( !parseOp( value, options.op ) )
+        {
+          return usage();
+        }
+        break;
+      case 'c':
+        options.connections = std::strtoul( value, 0, 10 );
+        break;
+      case 'd':
+        options.depth = std::strtoul( value, 0, 10 );
+        break;
+      case 'n':
+        options.requests = std::strtoul( value, 0, 10 );
+        break;
+      case 'm':
+        options.message = value;
+        break;
+      default:
+        return usage();
+    }
+  }
+  if ( options.connections == 0 || options.depth == 0 || options.requests == 0 )
+  {
+    return usage();
+  }
+
+  std::vector< Result > results( options.connections );
+  std::vector< std::thread > threads;
+  const Clock::time_point start = Clock::now();
+  for ( unsigned long idx = 0; idx < options.connections; ++idx )
+  {
+    results[ idx ].errors = 0;
+    results[ idx ].bytesOut = 0;
+    results[ idx ].bytesIn = 0;
+    results[ idx ].failed = false;
+    threads.push_back( std::thread( run, std::cref( options ), std::ref( results[ idx ] ) ) );
+  }
+  for ( unsigned long idx = 0; idx < threads.size(); ++idx )
+  {
+    threads[ idx ].join();
+  }
+  const double elapsed = std::chrono::duration< double >( Clock::now() - start ).count();
+
+  std::vector< double > latencies;
+  unsigned long errors = 0;
+  unsigned long failures = 0;
+  unsigned long long bytesOut = 0;
+  unsigned long long bytesIn = 0;
+  for ( unsigned long idx = 0; idx < results.size(); ++idx )
+  {
+    latencies.insert( latencies.end(), results[ idx ].latencies.begin(), results[ idx ].latencies.end() );
+    errors += results[ idx ].errors;
+    failures += results[ idx ].failed;
+    bytesOut += results[ idx ].bytesOut;
+    bytesIn += results[ idx ].bytesIn;
+  }
+
+  std::printf( "requests: %lu on %lu connections, %lu in flight on each\n",
+               static_cast< unsigned long >( latencies.size() ), options.connections, options.depth );
+  if ( elapsed > 0.0 )
+  {
+    std::printf( "throughput: %.0f requests/s, %.1f MB/s out, %.1f MB/s in\n",
+                 latencies.size() / elapsed, bytesOut / elapsed / 1e6, bytesIn / elapsed / 1e6 );
+  }
+  if ( !latencies.empty() )
+  {
+    std::sort( latencies.begin(), latencies.end() );
+    std::printf( "latency: p50 %.0f us, p99 %.0f us, max %.0f us\n",
+                 percentile( latencies, 0.5 ), percentile( latencies, 0.99 ), latencies.back() );
+  }
+  std::printf( "errors: %lu replies, %lu connections failed\n", errors, failures );
+
+  return errors == 0 && failures == 0 ? 0 : 1;
+}
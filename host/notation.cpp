@@ -0,0 +1,253 @@
+/*
+  notation.cpp
+
+  Decodes Morse code written out as text.
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include "notation.h"
+
+#if defined( __SSE2__ )
+#include <emmintrin.h>
+#include <stdint.h>
+#define NOTATION_SSE2 1
+#else
+#define NOTATION_SSE2 0
+#endif
+
+// Typedefs
+
+// What each byte of notation does. Separators, from LETTER_BYTE on, end the letter before them.
+enum ByteClass { DOT_BYTE, DASH_BYTE, OTHER_BYTE, LETTER_BYTE, WORD_BYTE, LINE_BYTE };
+
+struct ClassTable
+{
+  ClassTable()
+  {
+    for ( unsigned int idx = 0; idx < sizeof( classes ); ++idx )
+    {
+      classes[ idx ] = OTHER_BYTE;
+    }
+    classes[ static_cast< unsigned char >( '.' ) ] = DOT_BYTE;
+    classes[ static_cast< unsigned char >( '-' ) ] = DASH_BYTE;
+    classes[ static_cast< unsigned char >( '_' ) ] = DASH_BYTE;
+    classes[ static_cast< unsigned char >( ' ' ) ] = LETTER_BYTE;
+    classes[ static_cast< unsigned char >( '\t' ) ] = LETTER_BYTE;
+    classes[ static_cast< unsigned char >( '\r' ) ] = LETTER_BYTE;
+    classes[ static_cast< unsigned char >( '/' ) ] = WORD_BYTE;
+    classes[ static_cast< unsigned char >( '|' ) ] = WORD_BYTE;
+    classes[ static_cast< unsigned char >( '\n' ) ] = LINE_BYTE;
+  }
+
+  unsigned char classes[ 256 ];
+};
+
+// Constants
+static const ClassTable classTable;
+
+// Characters separators copy to the output, by ByteClass.
+static const char separatorCharacters[] = { 0, 0, 0, 0, ' ', '\n' };
+
+// Length of a letter that's too long, or holds something other than dots and dashes.
+static const unsigned int SPOILED = NotationDecoder::SPOILED;
+
+// decodeBytes()
+// Arguments:
+//   input - notation bytes.
+//   count - number of bytes.
+//   out - where decoded characters are written.
+//   letter - NotationDecoder::letters.
+//   elements, dashBits - The letter read so far. Updated.
+// Returns:
+//   The end of the decoded characters.
+// Decodes a byte at a time.
+static char * decodeBytes( const char * const input, const size_t count, char * out,
+                           const char ( * const letter )[ Morse::CODEWORD_LIMIT ],
+                           unsigned int & elements, unsigned int & dashBits )
+{
+  for ( size_t idx = 0; idx < count; ++idx )
+  {
+    const unsigned int byteClass = classTable.classes[ static_cast< unsigned char >( input[ idx ] ) ];
+
+    if ( byteClass <= DASH_BYTE )
+    {
+      if ( elements < SPOILED )
+      {
+        dashBits |= byteClass << elements;
+        ++elements;
+      }
+    }
+    else if ( byteClass == OTHER_BYTE )
+    {
+      elements = SPOILED;
+    }
+    else
+    {
+      if ( elements != 0 )
+      {
+        *out++ = letter[ elements ][ dashBits ];
+        elements = 0;
+        dashBits = 0;
+      }
+      if ( byteClass >= WORD_BYTE )
+      {
+        *out++ = separatorCharacters[ byteClass ];
+      }
+    }
+  }
+
+  return out;
+}
+
+#if NOTATION_SSE2
+static const unsigned int blockLength = 64; // Bytes classified at a time, one bit each.
+
+// Bits for the bytes of a block, set where the byte is of a kind. Lowest bit first.
+struct BlockMasks
+{
+  uint64_t dashes;        // DASHes.
+  uint64_t separators;    // Everything that ends a letter.
+  uint64_t wordsOrLines;  // Separators that copy a character to the output.
+  uint64_t lines;         // Line breaks.
+  uint64_t notation;      // Everything above, and DOTs.
+};
+
+// classify()
+// Arguments:
+//   block - blockLength bytes.
+//   masks - Storage for the block's masks.
+static void classify( const char * const block, BlockMasks & masks )
+{
+  masks.dashes = masks.separators = masks.wordsOrLines = masks.lines = masks.notation = 0;
+
+  for ( unsigned int idx = 0; idx < blockLength / 16; ++idx )
+  {
+    const __m128i bytes = _mm_loadu_si128( reinterpret_cast< const __m128i * >( block ) + idx );
+    const __m128i dash = _mm_or_si128( _mm_cmpeq_epi8( bytes, _mm_set1_epi8( '-' ) ), _mm_cmpeq_epi8( bytes, _mm_set1_epi8( '_' ) ) );
+    const __m128i line = _mm_cmpeq_epi8( bytes, _mm_set1_epi8( '\n' ) );
+    const __m128i wordOrLine = _mm_or_si128( line, _mm_or_si128( _mm_cmpeq_epi8( bytes, _mm_set1_epi8( '/' ) ),
+                                                                 _mm_cmpeq_epi8( bytes, _mm_set1_epi8( '|' ) ) ) );
+    const __m128i blank = _mm_or_si128( _mm_cmpeq_epi8( bytes, _mm_set1_epi8( ' ' ) ),
+                                        _mm_or_si128( _mm_cmpeq_epi8( bytes, _mm_set1_epi8( '\t' ) ),
+                                                      _mm_cmpeq_epi8( bytes, _mm_set1_epi8( '\r' ) ) ) );
+    const __m128i separator = _mm_or_si128( wordOrLine, blank );
+    const __m128i notation = _mm_or_si128( _mm_or_si128( dash, separator ), _mm_cmpeq_epi8( bytes, _mm_set1_epi8( '.' ) ) );
+
+    const unsigned int shift = 16 * idx;
+    masks.dashes |= static_cast< uint64_t >( _mm_movemask_epi8( dash ) ) << shift;
+    masks.separators |= static_cast< uint64_t >( _mm_movemask_epi8( separator ) ) << shift;
+    masks.wordsOrLines |= static_cast< uint64_t >( _mm_movemask_epi8( wordOrLine ) ) << shift;
+    masks.lines |= static_cast< uint64_t >( _mm_movemask_epi8( line ) ) << shift;
+    masks.notation |= static_cast< uint64_t >( _mm_movemask_epi8( notation ) ) << shift;
+  }
+}
+#endif
+
+NotationDecoder::NotationDecoder() :
+  length( 0 ),
+  dashes( 0 )
+{
+  // The reverse index, by length and dashes rather than by codeword, so decoding can look letters up
+  // without building codewords, calls, or bounds checks. Dashes past the length are ignored, and spoiled
+  // letters are '?'.
+  for ( unsigned int elements = 0; elements <= SPOILED; ++elements )
+  {
+    for ( unsigned int dashBits = 0; dashBits < Morse::CODEWORD_LIMIT; ++dashBits )
+    {
+      const unsigned int lead = 1u << elements;
+      letters[ elements ][ dashBits ] =
+        elements < SPOILED ? Morse::codewordToAscii( lead | ( dashBits & ( lead - 1 ) ) ) : '?';
+    }
+  }
+}
+
+size_t NotationDecoder::decode( const char * const input, const size_t count, char * const output )
+{
+  // Locals, since the compiler must assume stores to the output could change members.
+  const char ( * const letter )[ Morse::CODEWORD_LIMIT ] = letters;
+  unsigned int elements = length;
+  unsigned int dashBits = dashes;
+  size_t idx = 0;
+  char * out = output;
+
+  #if NOTATION_SSE2
+  // Notation alternates elements and separators too often for a branch per byte to predict. Instead,
+  // find every kind of byte in a block at once, then take the letters a separator at a time, each
+  // one's dashes straight out of the mask. Blocks with anything but notation in them, which should be
+  // rare, go a byte at a time below.
+  for ( ; idx + blockLength <= count; idx += blockLength )
+  {
+    BlockMasks masks;
+    classify( input + idx, masks );
+    if ( masks.notation != ~static_cast< uint64_t >( 0 ) )
+    {
+      out = decodeBytes( input + idx, blockLength, out, letter, elements, dashBits );
+      continue;
+    }
+
+    uint64_t remaining = masks.separators;
+    unsigned int start = 0;
+    while ( remaining != 0 )
+    {
+      const unsigned int end = __builtin_ctzll( remaining );
+      remaining &= remaining - 1;
+
+      // The letter is what's left over from before, and the bytes from start to end. Anything longer
+      // than a codeword holds is cut to SPOILED elements, which decode to '?'.
+      const unsigned int read = end - start < SPOILED ? end - start : SPOILED;
+      const unsigned int total = elements + read < SPOILED ? elements + read : SPOILED;
+      const unsigned int letterDashes = dashBits | static_cast< unsigned int >( masks.dashes >> start ) << elements;
+
+      // Both stores land within the room the letter and separator take, whether they count or not.
+      *out = letter[ total ][ letterDashes % Morse::CODEWORD_LIMIT ];
+      out += total != 0;
+      const unsigned int byteClass = classTable.classes[ static_cast< unsigned char >( input[ idx + end ] ) ];
+      *out = separatorCharacters[ byteClass ];
+      out += byteClass >= WORD_BYTE;
+
+      elements = 0;
+      dashBits = 0;
+      start = end + 1;
+    }
+
+    // Carry the start of the next letter over.
+    if ( start < blockLength )
+    {
+      const unsigned int read = blockLength - start;
+      if ( elements + read < SPOILED )
+      {
+        dashBits |= static_cast< unsigned int >( masks.dashes >> start ) << elements;
+        elements += read;
+      }
+      else
+      {
+        elements = SPOILED;
+      }
+    }
+  }
+  #endif
+
+  out = decodeBytes( input + idx, count - idx, out, letter, elements, dashBits );
+
+  length = elements;
+  dashes = dashBits;
+  return out - output;
+}
+
+size_t NotationDecoder::finish( char * const output )
+{
+  if ( length == 0 )
+  {
+    return 0;
+  }
+
+  output[ 0 ] = letters[ length ][ dashes ];
+  length = 0;
+  dashes = 0;
+  return 1;
+}
@@ -0,0 +1,58 @@
+/*
+  notation.h
+
+  Decodes Morse code written out as text: '.' for a DOT, '-' (or '_') for a DASH, blanks between
+  letters, and '/' (or '|') between words, as in ".- -... / -.-.". Decodes in bulk, a buffer at a time,
+  so input of any size streams through a fixed amount of memory. A letter can span buffers.
+
+  Each letter is packed into a Morse codeword (see Morse::packCodeword()) and looked up in a copy of
+  the reverse index. Letters that are too long, or that hold anything other than dots and dashes, decode
+  to '?'. Line breaks end a letter and are copied to the output. On x86 the bytes are classified 64 at a
+  time with SSE2, so whole letters are read out of bit masks.
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#ifndef NOTATION_H
+#define NOTATION_H
+
+#include <cstddef>
+#include "morse.h"
+
+class NotationDecoder
+{
+  public:
+  // Constructor
+  // Copies Morse's reverse index, so don't construct one before main() starts.
+  NotationDecoder();
+
+  // decode()
+  // Arguments:
+  //   input - next notation bytes.
+  //   count - number of bytes.
+  //   output - where decoded characters are written. Room for count + 1 characters.
+  // Returns:
+  //   Number of characters written.
+  size_t decode( const char * const input, const size_t count, char * const output );
+
+  // finish()
+  // Arguments:
+  //   output - where the last letter is written. Room for 1 character.
+  // Returns:
+  //   Number of characters written.
+  size_t finish( char * const output );
+
+  // Length of a letter that's too long, or holds something other than dots and dashes.
+  static const unsigned int SPOILED = Morse::SEQUENCE_LENGTH + 1;
+
+  private:
+  unsigned int length;                                          // Elements read of the current letter.
+  unsigned int dashes;                                          // Its DASHes, as in a codeword.
+  char         letters[ SPOILED + 1 ][ Morse::CODEWORD_LIMIT ];  // Character for each length and dashes.
+};
+
+#endif
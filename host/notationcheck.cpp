@@ -0,0 +1,208 @@
+/*
+  notationcheck.cpp
+
+  Checks the dot and dash notation decoder (notation.h) against a byte at a time reference built on
+  Morse::morseToAscii(): known strings, then random notation split into buffers of random size, so
+  letters span buffers and the 64-byte blocks start anywhere in them.
+
+  Usage: notationcheck
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include "check.h"
+#include "morse.h"
+#include "notation.h"
+
+// Constants
+static const unsigned char guard = 0xA5;  // Fills output past the room decode() is allowed.
+
+// reference()
+// Arguments:
+//   notation - Dots and dashes, as notation.h describes them.
+// Returns:
+//   The decoded text, worked out one byte at a time.
+static std::string reference( const std::string & notation )
+{
+  std::string text;
+  Morse::MorseCodeElement sequence[ Morse::SEQUENCE_LENGTH ];
+  unsigned int elements = 0;
+  bool spoiled = false;
+
+  for ( size_t idx = 0; idx <= notation.size(); ++idx )
+  {
+    const char character = idx < notation.size() ? notation[ idx ] : ' ';
+    if ( character == '.' || character == '-' || character == '_' )
+    {
+      if ( elements >= Morse::SEQUENCE_LENGTH )
+      {
+        spoiled = true;
+      }
+      else
+      {
+        sequence[ elements ] = character == '.' ? Morse::DOT : Morse::DASH;
+      }
+      ++elements;
+      continue;
+    }
+
+    const bool separator = character == ' ' || character == '\t' || character == '\r' || character == '/' ||
+                           character == '|' || character == '\n';
+    if ( !separator )
+    {
+      spoiled = true;
+      ++elements;
+      continue;
+    }
+
+    if ( elements != 0 )
+    {
+      if ( spoiled )
+      {
+        text += '?';
+      }
+      else
+      {
+        std::fill( sequence + elements, sequence + Morse::SEQUENCE_LENGTH, Morse::SPACE );
+        text += Morse::morseToAscii( sequence );
+      }
+    }
+    elements = 0;
+    spoiled = false;
+
+    if ( idx < notation.size() && ( character == '/' || character == '|' ) )
+    {
+      text += ' ';
+    }
+    else if ( character == '\n' )
+    {
+      text += '\n';
+    }
+  }
+
+  return text;
+}
+
+// decode()
+// Arguments:
+//   check - Records buffer overruns.
+//   decoder - Decoder to use. Left finished.
+//   notation - Input.
+//   pieces - Lengths to split it into, in turn, repeating. Empty for all at once.
+// Returns:
+//   The decoded text.
+static std::string decode( Check & check, NotationDecoder & decoder, const std::string & notation,
+                           const std::vector< size_t > & pieces )
+{
+  std::string text;
+  std::vector< char > output;
+  size_t piece = 0;
+
+  for ( size_t done = 0; done < notation.size(); )
+  {
+    const size_t count = pieces.empty() ? notation.size() : std::min( pieces[ piece++ % pieces.size() ], notation.size() - done );
+    output.assign( count + 1 + 16, static_cast< char >( guard ) );
+    const size_t written = decoder.decode( notation.data() + done, count, output.data() );
+    check( written <= count + 1, "%lu bytes decode to %lu characters", static_cast< unsigned long >( count ),
+           static_cast< unsigned long >( written ) );
+    check( std::count( output.begin() + count + 1, output.end(), static_cast< char >( guard ) ) == 16,
+           "decode() of %lu bytes writes past count + 1", static_cast< unsigned long >( count ) );
+    text.append( output.data(), std::min( written, count + 1 ) );
+    done += count;
+  }
+
+  char last;
+  text.append( &last, decoder.finish( &last ) );
+  return text;
+}
+
+static void checkKnown( Check & check )
+{
+  const char * const cases[][ 2 ] =
+  {
+    { "", "" },
+    { ".- -... / -.-.", "AB C" },
+    { ".-_|-... ", "W B" },
+    { "...\t---\r...\n", "SOS\n" },
+    { "-----/.----", "0 1" },
+    { "......", "?" },                 // Longer than any letter.
+    { ".-x -", "?T" },                 // Not notation.
+    { "  //  ", "  " },
+    { "\n\n.", "\n\nE" },
+  };
+
+  NotationDecoder decoder;
+  for ( unsigned int idx = 0; idx < sizeof( cases ) / sizeof( cases[ 0 ] ); ++idx )
+  {
+    const std::string notation = cases[ idx ][ 0 ];
+    const std::string text = decode( check, decoder, notation, std::vector< size_t >() );
+    check( text == cases[ idx ][ 1 ], "\"%s\" decodes as \"%s\", not \"%s\"", notation.c_str(), text.c_str(), cases[ idx ][ 1 ] );
+    check( reference( notation ) == cases[ idx ][ 1 ], "reference decodes \"%s\" as \"%s\"", notation.c_str(),
+           reference( notation ).c_str() );
+  }
+}
+
+static void checkRandom( Check & check )
+{
+  // Mostly letters, with every separator, and the odd byte that isn't notation.
+  static const char bytes[] = "..........----------__      //|\n\t\rx";
+  std::mt19937 random( 35 );
+  NotationDecoder decoder;
+
+  for ( unsigned int trial = 0; trial < 300; ++trial )
+  {
+    std::string notation( random() % 5000, ' ' );
+    const unsigned int letters = trial % 3 == 0 ? 6 : 4;   // Some trials have long, spoiled letters.
+    for ( size_t idx = 0; idx < notation.size(); )
+    {
+      // A letter, then a separator.
+      const size_t length = std::min< size_t >( 1 + random() % letters, notation.size() - idx );
+      for ( size_t element = 0; element < length; ++element )
+      {
+        notation[ idx++ ] = random() % 2 == 0 ? '.' : '-';
+      }
+      if ( idx < notation.size() )
+      {
+        notation[ idx++ ] = bytes[ random() % ( sizeof( bytes ) - 1 ) ];
+      }
+    }
+
+    std::vector< size_t > pieces;
+    if ( trial % 4 != 0 )
+    {
+      for ( unsigned int idx = 0; idx < 8; ++idx )
+      {
+        pieces.push_back( idx % 2 == 0 ? 64 * ( 1 + random() % 4 ) : 1 + random() % 200 );
+      }
+    }
+
+    const std::string text = decode( check, decoder, notation, pieces );
+    const std::string expected = reference( notation );
+    size_t mismatch = 0;
+    while ( mismatch < text.size() && mismatch < expected.size() && text[ mismatch ] == expected[ mismatch ] )
+    {
+      ++mismatch;
+    }
+    check( text == expected, "trial %u, %lu bytes: differs from the reference at character %lu of %lu", trial,
+           static_cast< unsigned long >( notation.size() ), static_cast< unsigned long >( mismatch ),
+           static_cast< unsigned long >( expected.size() ) );
+  }
+}
+
+int main()
+{
+  Check check( "notationcheck" );
+
+  checkKnown( check );
+  checkRandom( check );
+
+  return check.finish();
+}
@@ -0,0 +1,304 @@
+/*
+  replay.cpp
+
+  Replays a recording of raw key edges through the sketch's own debounce and decode code, as fast as
+  the host can run it. Recordings are captures of the serial port taken with RECORD_EDGES turned on in
+  trace.h (see edgelog.h): edge records mixed with whatever text the sketch printed.
+
+  Each replay steps the virtual clock one millisecond at a time, and at every edge, and runs what
+  loop() runs with the key in between: MorseToAscii::timestamp() while the key is up, KeyInput::sample(),
+  then, when a keypress ends, MorseToAscii::setDotDuration() with the debouncer's estimate of the
+  sender's speed, Morse::classifyMark() and MorseToAscii::keypress(). The decoded text goes
+  to standard output. The report on standard error says whether it matches what the sketch printed,
+  how long each edge took to process, how much faster than real time the replay ran, and what the
+  debouncer made of the key's contact bounce.
+
+  Usage: replay [-n repeats] [capture]
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "WProgram.h"
+#include "edgelog.h"
+#include "keyinput.h"
+#include "morse.h"
+#include "morsetoascii.h"
+#include "outputqueue.h"
+
+// Typedefs
+typedef std::chrono::steady_clock Clock;
+
+struct Edge
+{
+  unsigned long long time;   // Microseconds since the sketch started.
+  int                level;  // Level of the key pin after the edge.
+};
+
+// Constants
+
+// Time to keep the clock running after the last edge, so the last character and word end.
+static const unsigned long tailDuration = 2 * Morse::WORD_SPACE_DURATION; // ms
+
+// Replays a recording through the sketch's key handling and decoder.
+class Replayer
+{
+  public:
+  Replayer()
+  {
+    mta.setOutput( output );
+  }
+
+  // tick()
+  // Arguments:
+  //   now - Time in milliseconds since startup.
+  //   level - Level of the key pin.
+  // Does what loop() does with the key.
+  void tick( const unsigned long now, const int level )
+  {
+    hostSetTime( now * 1000 );
+
+    if ( keyInput.state() == KeyInput::KEY_UP )
+    {
+      mta.timestamp( now );
+    }
+
+    if ( keyInput.sample( now, level ) )
+    {
+      mta.setDotDuration( keyInput.dotEstimate() );
+      const Morse::MorseCodeElement key = Morse::classifyMark( keyInput.keyDuration(), mta.dotDuration() );
+      if ( key != Morse::SPACE )
+      {
+        mta.keypress( key, now );
+      }
+    }
+
+    char character;
+    while ( output.pop( character ) )
+    {
+      text += character;
+    }
+  }
+
+  // key()
+  // Returns:
+  //   The key input, for its debounce statistics.
+  const KeyInput & key() const
+  {
+    return keyInput;
+  }
+
+  std::string text;
+
+  private:
+  KeyInput     keyInput;
+  MorseToAscii mta;
+  OutputQueue  output;
+};
+
+// load()
+// Arguments:
+//   input - Capture of the sketch's serial port.
+//   edges - Storage for the edges recorded in it.
+//   text - Storage for the text the sketch printed.
+// Returns:
+//   false if the capture couldn't be read.
+static bool load( std::FILE * const input, std::vector< Edge > & edges, std::string & text )
+{
+  EdgeLogParser parser;
+  unsigned long long time = 0;
+
+  int byte;
+  while ( ( byte = std::fgetc( input ) ) != EOF )
+  {
+    if ( ( byte & EdgeLog::RECORD_FLAG ) == 0 )
+    {
+      text += static_cast< char >( byte );
+    }
+    else if ( parser.parse( static_cast< unsigned char >( byte ) ) )
+    {
+      time += parser.delta();
+      const Edge edge = { time, parser.level() };
+      edges.push_back( edge );
+    }
+  }
+
+  return std::ferror( input ) == 0;
+}
+
+// replay()
+// Arguments:
+//   edges - Recording to replay.
+//   costs - Storage for the time taken by the loop() pass that sees each edge, in nanoseconds, added
+//           to the end.
+//   key - Storage for the key input as it was at the end of the replay.
+// Returns:
+//   Decoded text.
+static std::string replay( const std::vector< Edge > & edges, std::vector< double > & costs, KeyInput & key )
+{
+  Replayer replayer;
+  unsigned long tick = 0;
+  int level = HIGH;
+
+  for ( size_t idx = 0; idx < edges.size(); ++idx )
+  {
+    const unsigned long edgeTime = static_cast< unsigned long >( edges[ idx ].time / 1000 );
+
+    // The loop runs many times a millisecond, but between edges every pass in a millisecond does the
+    // same thing, so once is enough. Then the pass that sees the edge, which is the one timed: the
+    // idle passes before it would make the cost grow with the gap between edges.
+    for ( ; tick <= edgeTime; ++tick )
+    {
+      replayer.tick( tick, level );
+    }
+    level = edges[ idx ].level;
+    const Clock::time_point start = Clock::now();
+    replayer.tick( edgeTime, level );
+
+    costs.push_back( std::chrono::duration< double, std::nano >( Clock::now() - start ).count() );
+  }
+
+  for ( const unsigned long end = tick + tailDuration; tick < end; ++tick )
+  {
+    replayer.tick( tick, level );
+  }
+
+  key = replayer.key();
+  return replayer.text;
+}
+
+// percentile()
+// Arguments:
+//   sorted - Values in ascending order. Not empty.
+//   fraction - 0 to 1.
+static double percentile( const std::vector< double > & sorted, const double fraction )
+{
+  return sorted[ static_cast< size_t >( fraction * ( sorted.size() - 1 ) ) ];
+}
+
+static int usage()
+{
+  std::fprintf( stderr,
+                "usage: replay [-n repeats] [capture]\n"
+                "  capture is a serial port capture taken with RECORD_EDGES on. Default: standard input.\n" );
+  return 2;
+}
+
+int main( int argc, char * argv[] )
+{
+  unsigned long repeats = 1;
+  const char * path = 0;
+
+  int arg = 1;
+  for ( ; arg < argc && argv[ arg ][ 0 ] == '-' && argv[ arg ][ 1 ] != 0; ++arg )
+  {
+    if ( arg + 1 >= argc || argv[ arg ][ 1 ] != 'n' )
+    {
+      return usage();
+    }
+    repeats = std::strtoul( argv[ ++arg ], 0, 10 );
+  }
+  if ( arg < argc )
+  {
+    path = argv[ arg++ ];
+  }
+  if ( arg < argc || repeats == 0 )
+  {
+    return usage();
+  }
+
+  std::FILE * const input = ( path == 0 || std::strcmp( path, "-" ) == 0 ) ? stdin : std::fopen( path, "rb" );
+  if ( input == 0 )
+  {
+    std::perror( path );
+    return 1;
+  }
+
+  std::vector< Edge > edges;
+  std::string firmwareText;
+  const bool loaded = load( input, edges, firmwareText );
+  if ( input != stdin )
+  {
+    std::fclose( input );
+  }
+  if ( !loaded )
+  {
+    std::perror( "replay: read" );
+    return 1;
+  }
+
+  // Every replay has to decode the same thing, or something depends on more than the recording.
+  std::vector< double > costs;
+  costs.reserve( edges.size() * repeats );
+  const Clock::time_point start = Clock::now();
+  KeyInput key;
+  const std::string text = replay( edges, costs, key );
+  bool deterministic = true;
+  for ( unsigned long count = 1; count < repeats; ++count )
+  {
+    deterministic = replay( edges, costs, key ) == text && deterministic;
+  }
+  const double elapsed = std::chrono::duration< double >( Clock::now() - start ).count();
+
+  std::fwrite( text.data(), 1, text.size(), stdout );
+
+  const double session = edges.empty() ? 0.0 : edges.back().time / 1e6 + tailDuration / 1e3;
+  std::fprintf( stderr, "edges: %lu, session: %.3f s, repeats: %lu\n",
+                static_cast< unsigned long >( edges.size() ), session, repeats );
+
+  // The sketch's text can hold more than decoded characters, and the capture can end before the sketch
+  // printed the last of them, so compare as far as both go.
+  const size_t length = std::min( text.size(), firmwareText.size() );
+  const size_t offset = std::mismatch( text.begin(), text.begin() + length, firmwareText.begin() ).first -
+                        text.begin();
+  const bool matched = offset == length;
+  if ( firmwareText.empty() )
+  {
+    std::fprintf( stderr, "decode: %lu characters, no sketch output to compare\n",
+                  static_cast< unsigned long >( text.size() ) );
+  }
+  else if ( matched )
+  {
+    std::fprintf( stderr, "decode: %lu characters, matches sketch output (%lu decoded after the capture ends)\n",
+                  static_cast< unsigned long >( text.size() ), static_cast< unsigned long >( text.size() - length ) );
+  }
+  else
+  {
+    std::fprintf( stderr, "decode: %lu characters, differs from sketch output at character %lu\n",
+                  static_cast< unsigned long >( text.size() ), static_cast< unsigned long >( offset ) );
+  }
+  std::fprintf( stderr, "debounce: %lu edges, %lu bounces ignored, longest bounce %lu ms, lockout %lu ms at %lu ms dots\n",
+                key.edgeCount(), key.bounceCount(), key.longestBounce(), key.lockout(), key.dotEstimate() );
+  if ( !deterministic )
+  {
+    std::fprintf( stderr, "decode: repeats disagree\n" );
+  }
+
+  if ( !costs.empty() )
+  {
+    std::sort( costs.begin(), costs.end() );
+    double total = 0.0;
+    for ( size_t idx = 0; idx < costs.size(); ++idx )
+    {
+      total += costs[ idx ];
+    }
+    std::fprintf( stderr, "cost per edge: mean %.0f ns, p50 %.0f ns, p99 %.0f ns, max %.0f ns\n",
+                  total / costs.size(), percentile( costs, 0.5 ), percentile( costs, 0.99 ), costs.back() );
+  }
+  if ( elapsed > 0.0 )
+  {
+    std::fprintf( stderr, "speed: %.0f times real time\n", session * repeats / elapsed );
+  }
+
+  return ( firmwareText.empty() || matched ) && deterministic ? 0 : 1;
+}
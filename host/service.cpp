@@ -0,0 +1,148 @@
+/*
+  service.cpp
+
+  The work behind morsed's requests.
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <cctype>
+#include "audio.h"
+#include "service.h"
+
+MorseService::MorseService( const unsigned int sampleRate, const double frequency ) :
+  sampleRate( sampleRate ),
+  frequency( frequency )
+{
+}
+
+Frame::Status MorseService::handle( const unsigned char op, const unsigned char * const payload, const size_t length,
+                                    std::vector< unsigned char > & reply )
+{
+  const char * const characters = reinterpret_cast< const char * >( payload );
+  const size_t start = reply.size();
+
+  switch ( op )
+  {
+    case Frame::ENCODE:
+      encode( characters, length, reply );
+      break;
+    case Frame::DECODE:
+    {
+      reply.resize( start + length + 1 );
+      char * const output = reinterpret_cast< char * >( reply.data() + start );
+      size_t decoded = notationDecoder.decode( characters, length, output );
+      decoded += notationDecoder.finish( output + decoded );
+      reply.resize( start + decoded );
+      break;
+    }
+    case Frame::RENDER:
+      return render( characters, length, reply );
+    case Frame::DECODE_TIMING:
+      return decodeTiming( payload, length, reply );
+    default:
+      return Frame::BAD_REQUEST;
+  }
+
+  if ( reply.size() - start > Frame::MAX_REPLY )
+  {
+    reply.resize( start );
+    return Frame::TOO_LONG;
+  }
+
+  return Frame::OK;
+}
+
+void MorseService::encode( const char * const text, const size_t length, std::vector< unsigned char > & notation )
+{
+  bool inWord = false;      // A letter of the current word has been encoded.
+  bool wordEnded = false;   // A word has been encoded, and a SPACE has ended it since.
+
+  for ( size_t idx = 0; idx < length; ++idx )
+  {
+    if ( std::isspace( static_cast< unsigned char >( text[ idx ] ) ) )
+    {
+      wordEnded = wordEnded || inWord;
+      inWord = false;
+      continue;
+    }
+
+    Morse::MorseCodeElement sequence[ Morse::SEQUENCE_LENGTH ];
+    if ( !Morse::asciiToMorse( text[ idx ], sequence ) )
+    {
+      continue;
+    }
+
+    if ( wordEnded )
+    {
+      notation.push_back( ' ' );
+      notation.push_back( '/' );
+      notation.push_back( ' ' );
+    }
+    else if ( inWord )
+    {
+      notation.push_back( ' ' );
+    }
+    inWord = true;
+    wordEnded = false;
+
+    for ( unsigned int element = 0; element < Morse::SEQUENCE_LENGTH && sequence[ element ] != Morse::SPACE; ++element )
+    {
+      notation.push_back( sequence[ element ] == Morse::DASH ? '-' : '.' );
+    }
+  }
+}
+
+Frame::Status MorseService::render( const char * const characters, const size_t length, std::vector< unsigned char > & reply )
+{
+  KeyingSchedule schedule;
+  runs.clear();
+  symbols.clear();
+  for ( size_t idx = 0; idx < length; ++idx )
+  {
+    const char character = std::isspace( static_cast< unsigned char >( characters[ idx ] ) ) ? ' ' : characters[ idx ];
+    schedule.addCharacter( character, symbols, runs );
+  }
+  schedule.finish( runs );
+
+  // Audio is some thousand times longer than its text, so stop as soon as it's too long.
+  const size_t start = reply.size();
+  ToneRenderer tone( sampleRate, frequency, 0.5, 5.0 );
+  for ( size_t idx = 0; idx < runs.size(); ++idx )
+  {
+    tone.add( runs[ idx ], reply );
+    if ( reply.size() - start > Frame::MAX_REPLY )
+    {
+      reply.resize( start );
+      return Frame::TOO_LONG;
+    }
+  }
+
+  return Frame::OK;
+}
+
+Frame::Status MorseService::decodeTiming( const unsigned char * const payload, const size_t length, std::vector< unsigned char > & reply )
+{
+  if ( length % 4 != 0 )
+  {
+    return Frame::BAD_REQUEST;
+  }
+
+  runs.resize( length / 4 );
+  for ( size_t idx = 0; idx < runs.size(); ++idx )
+  {
+    runs[ idx ] = Frame::getUint32( payload + 4 * idx );
+  }
+
+  text.clear();
+  runDecoder.reset();
+  runDecoder.add( runs.data(), runs.size(), text );
+  runDecoder.finish( text );
+
+  reply.insert( reply.end(), text.begin(), text.end() );
+  return Frame::OK;
+}
@@ -0,0 +1,66 @@
+/*
+  service.h
+
+  The work behind morsed's requests (see frame.h), apart from the sockets. One MorseService serves any
+  number of requests one after another, and keeps its decoders and storage between them, so a request
+  costs only the work it asks for.
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#ifndef SERVICE_H
+#define SERVICE_H
+
+#include <string>
+#include <vector>
+#include "frame.h"
+#include "keying.h"
+#include "notation.h"
+
+class MorseService
+{
+  public:
+  // Constructor
+  // Arguments:
+  //   sampleRate - samples per second of RENDER replies.
+  //   frequency - tone frequency of RENDER replies, in Hz.
+  MorseService( const unsigned int sampleRate, const double frequency );
+
+  // handle()
+  // Arguments:
+  //   op - Frame::Op the request asks for.
+  //   payload - the request's payload.
+  //   length - payload bytes.
+  //   reply - where the reply payload is appended.
+  // Returns:
+  //   Frame::Status of the reply. Nothing is appended unless it's OK.
+  Frame::Status handle( const unsigned char op, const unsigned char * const payload, const size_t length,
+                        std::vector< unsigned char > & reply );
+
+  // encode()
+  // Arguments:
+  //   text - ASCII text.
+  //   length - number of characters.
+  //   notation - where the text is appended in dot/dash notation.
+  // Letters are separated by SPACE and words by " / ". Characters that cannot be encoded are skipped,
+  // as AsciiToMorse does.
+  static void encode( const char * const text, const size_t length, std::vector< unsigned char > & notation );
+
+  private:
+  const unsigned int            sampleRate;
+  const double                  frequency;
+  NotationDecoder               notationDecoder;
+  RunDecoder                    runDecoder;
+  std::vector< unsigned long >  runs;
+  std::vector< unsigned char >  symbols;
+  std::string                   text;
+
+  Frame::Status render( const char * const characters, const size_t length, std::vector< unsigned char > & reply );
+  Frame::Status decodeTiming( const unsigned char * const payload, const size_t length, std::vector< unsigned char > & reply );
+};
+
+#endif
@@ -0,0 +1,202 @@
+/*
+  spscqueue.h
+
+  Bounded lock-free queue between one producer thread and one consumer thread. Pipelines pass pointers
+  to batches through it, so the copies are cheap and nothing is allocated once the pipeline is running.
+  A thread that has to wait spins for a little while, then sleeps until the other side pushes or pops,
+  so a stalled pipeline stage doesn't keep a core busy.
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+template< typename T >
+class SpscQueue
+{
+  public:
+  // Constructor
+  // Arguments:
+  //   capacity - Most items the queue holds. Rounded up to a power of two.
+  explicit SpscQueue( const size_t capacity ) :
+    slots( roundUp( capacity ) ),
+    mask( slots.size() - 1 ),
+    head( 0 ),
+    tail( 0 ),
+    producerWaiting( false ),
+    consumerWaiting( false )
+  {
+  }
+
+  // tryPush()
+  // Producer only. Returns false if the queue is full.
+  bool tryPush( const T & item )
+  {
+    if ( !insert( item ) )
+    {
+      return false;
+    }
+
+    wake( consumerWaiting, consumerWake );
+    return true;
+  }
+
+  // tryPop()
+  // Consumer only. Returns false if the queue is empty.
+  bool tryPop( T & item )
+  {
+    if ( !extract( item ) )
+    {
+      return false;
+    }
+
+    wake( producerWaiting, producerWake );
+    return true;
+  }
+
+  // push()
+  // Producer only. Waits for room.
+  void push( const T & item )
+  {
+    for ( unsigned int spin = 0; spin < SPIN_LIMIT; ++spin )
+    {
+      if ( tryPush( item ) )
+      {
+        return;
+      }
+    }
+
+    {
+      std::unique_lock< std::mutex > lock( sleepLock );
+      sleep( producerWaiting );
+      while ( !insert( item ) )
+      {
+        producerWake.wait( lock );
+      }
+      producerWaiting.store( false, std::memory_order_relaxed );
+    }
+    wake( consumerWaiting, consumerWake );
+  }
+
+  // pop()
+  // Consumer only. Waits for an item.
+  T pop()
+  {
+    T item;
+    for ( unsigned int spin = 0; spin < SPIN_LIMIT; ++spin )
+    {
+      if ( tryPop( item ) )
+      {
+        return item;
+      }
+    }
+
+    {
+      std::unique_lock< std::mutex > lock( sleepLock );
+      sleep( consumerWaiting );
+      while ( !extract( item ) )
+      {
+        consumerWake.wait( lock );
+      }
+      consumerWaiting.store( false, std::memory_order_relaxed );
+    }
+    wake( producerWaiting, producerWake );
+    return item;
+  }
+
+  private:
+  static const unsigned int SPIN_LIMIT = 1000;  // Tries before a waiting thread sleeps.
+
+  // insert(), extract()
+  // tryPush() and tryPop() without waking the other side, so they can be retried with sleepLock held.
+  bool insert( const T & item )
+  {
+    const size_t insertPoint = tail.load( std::memory_order_relaxed );
+    if ( insertPoint - head.load( std::memory_order_acquire ) == slots.size() )
+    {
+      return false;
+    }
+
+    slots[ insertPoint & mask ] = item;
+    tail.store( insertPoint + 1, std::memory_order_release );
+    return true;
+  }
+
+  bool extract( T & item )
+  {
+    const size_t extractPoint = head.load( std::memory_order_relaxed );
+    if ( extractPoint == tail.load( std::memory_order_acquire ) )
+    {
+      return false;
+    }
+
+    item = slots[ extractPoint & mask ];
+    head.store( extractPoint + 1, std::memory_order_release );
+    return true;
+  }
+
+  std::vector< T > slots;
+  const size_t     mask;
+
+  // Read and write points on separate cache lines, so the two threads don't fight over one.
+  alignas( 64 ) std::atomic< size_t > head;  // Next slot to pop. Written by the consumer.
+  alignas( 64 ) std::atomic< size_t > tail;  // Next slot to push. Written by the producer.
+
+  // Sleeping. A flag is only set with sleepLock held, and the other side looks at it after moving head
+  // or tail, so it only takes the lock when someone is asleep.
+  alignas( 64 ) std::atomic< bool > producerWaiting;
+  std::atomic< bool >               consumerWaiting;
+  std::mutex                        sleepLock;
+  std::condition_variable           producerWake;
+  std::condition_variable           consumerWake;
+
+  // sleep()
+  // Arguments:
+  //   waiting - The flag for the side about to sleep.
+  // Announces that this side is going to sleep. The fence here and the one in wake() make sure that
+  // either the sleeper sees the other side's progress when it tries again, or the other side sees the
+  // flag.
+  static void sleep( std::atomic< bool > & waiting )
+  {
+    waiting.store( true, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+  }
+
+  // wake()
+  // Arguments:
+  //   waiting - The flag for the other side.
+  //   wake - What the other side sleeps on.
+  void wake( const std::atomic< bool > & waiting, std::condition_variable & wake )
+  {
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    if ( waiting.load( std::memory_order_relaxed ) )
+    {
+      // Taking the lock waits for the sleeper to be inside wait(), so the notification isn't lost.
+      std::lock_guard< std::mutex > lock( sleepLock );
+      wake.notify_one();
+    }
+  }
+
+  static size_t roundUp( const size_t capacity )
+  {
+    size_t size = 1;
+    while ( size < capacity )
+    {
+      size <<= 1;
+    }
+    return size;
+  }
+};
+
+#endif
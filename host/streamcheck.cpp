@@ -0,0 +1,241 @@
+/*
+  streamcheck.cpp
+
+  Checks the Morse stream format (morsestream.h): varint and fixed width fields, a round trip through
+  MorseStreamWriter and MorseStreamReader, and seeking by character and by time, indexed and not. The
+  runs are long enough that the stream's time passes 2^32 ms, where a 32-bit index would wrap.
+
+  Usage: streamcheck
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "check.h"
+#include "morsestream.h"
+
+// Stream held in memory.
+class MemoryStream : public MorseStreamSink, public MorseStreamSource
+{
+  public:
+  MemoryStream() : position( 0 ) {}
+
+  virtual bool write( const unsigned char * const data, const unsigned int length )
+  {
+    bytes.insert( bytes.end(), data, data + length );
+    return true;
+  }
+
+  virtual bool read( unsigned char * const data, const unsigned int length )
+  {
+    if ( position + length > bytes.size() )
+    {
+      return false;
+    }
+    std::memcpy( data, bytes.data() + position, length );
+    position += length;
+    return true;
+  }
+
+  virtual bool seek( const unsigned long offset )
+  {
+    position = offset;
+    return offset <= bytes.size();
+  }
+
+  virtual unsigned long size()
+  {
+    return bytes.size();
+  }
+
+  std::vector< unsigned char > bytes;
+  unsigned long                position;
+};
+
+// Constants
+static const char alphabet[] = "ETIANMSURWDKGOHVFLPJBXCYZQ0123456789";
+static const unsigned long longRun = 3000000;  // ms. 1500 of these take the stream past 2^32 ms.
+
+static void checkFields( Check & check )
+{
+  unsigned char buffer[ MorseStream::VARINT_LENGTH + 1 ];
+  const unsigned long values[] =
+  {
+    0, 1, 127, 128, 0xFFFFFFFFul, 0x100000000ul, 0x7FFFFFFFFFFFFFFFul, ULONG_MAX
+  };
+
+  for ( unsigned int idx = 0; idx < sizeof( values ) / sizeof( values[ 0 ] ); ++idx )
+  {
+    const unsigned int length = MorseStream::putVarint( values[ idx ], buffer );
+    unsigned long value;
+    check( length <= MorseStream::VARINT_LENGTH, "varint %lu is %u bytes", values[ idx ], length );
+    check( MorseStream::getVarint( buffer, length, value ) == length && value == values[ idx ],
+           "varint %lu reads back as %lu", values[ idx ], value );
+    check( length == 1 || MorseStream::getVarint( buffer, length - 1, value ) == 0,
+           "truncated varint %lu is rejected", values[ idx ] );
+
+    MorseStream::putU64( values[ idx ], buffer );
+    check( MorseStream::getU64( buffer, value ) && value == values[ idx ], "u64 %lu reads back as %lu", values[ idx ], value );
+  }
+
+  // Eleven bytes is longer than any varint a writer produces.
+  std::memset( buffer, 0x80, sizeof( buffer ) );
+  buffer[ MorseStream::VARINT_LENGTH ] = 0x01;
+  unsigned long value;
+  check( MorseStream::getVarint( buffer, sizeof( buffer ), value ) == 0, "overlong varint is rejected" );
+
+  // Ten bytes with bits past the top of 64.
+  std::memset( buffer, 0xFF, MorseStream::VARINT_LENGTH );
+  buffer[ MorseStream::VARINT_LENGTH - 1 ] = 0x7F;
+  check( MorseStream::getVarint( buffer, MorseStream::VARINT_LENGTH, value ) == 0, "varint over 64 bits is rejected" );
+}
+
+// checkStream()
+// Arguments:
+//   indexCapacity - index entries the writer gets. 0 for an unindexed stream.
+static void checkStream( Check & check, const unsigned int indexCapacity )
+{
+  std::mt19937 random( 26 + indexCapacity );
+  std::string text;
+  std::vector< unsigned long > runs;
+  for ( unsigned int idx = 0; idx < 3000; ++idx )
+  {
+    text.push_back( random() % 6 == 0 ? ' ' : alphabet[ random() % ( sizeof( alphabet ) - 1 ) ] );
+    runs.push_back( longRun + random() % 1000 );
+  }
+
+  MemoryStream stream;
+  std::vector< MorseStream::IndexEntry > index( indexCapacity + 1 );
+  MorseStreamWriter writer( stream, indexCapacity != 0 ? index.data() : 0, indexCapacity );
+  writer.setDotDuration( 100 );
+  writer.setSource( "streamcheck" );
+  bool written = writer.begin();
+  for ( size_t idx = 0; idx < text.size(); ++idx )
+  {
+    written = written && writer.addCharacter( text[ idx ] );
+  }
+  for ( size_t idx = 0; idx < runs.size(); ++idx )
+  {
+    written = written && writer.addRun( runs[ idx ] );
+  }
+  written = written && writer.finish();
+  check( written, "writing with %u index entries", indexCapacity );
+
+  // Straight through, characters then runs.
+  MorseStreamReader reader( stream );
+  if ( !check( reader.open(), "opening with %u index entries", indexCapacity ) )
+  {
+    return;
+  }
+  check( reader.dotDuration() == 100 && std::strcmp( reader.source(), "streamcheck" ) == 0, "metadata" );
+
+  std::string decoded;
+  for ( char character = reader.readCharacter(); character != 0; character = reader.readCharacter() )
+  {
+    decoded.push_back( character );
+  }
+  check( decoded == text, "characters read back with %u index entries", indexCapacity );
+
+  MorseStreamReader runReader( stream );
+  runReader.open();
+  std::vector< unsigned long > startTimes;
+  unsigned long time = 0;
+  unsigned long duration;
+  size_t count = 0;
+  while ( runReader.readRun( duration ) )
+  {
+    check( count < runs.size() && duration == runs[ count ], "run %lu reads back", static_cast< unsigned long >( count ) );
+    startTimes.push_back( time );
+    time += duration;
+    ++count;
+  }
+  check( count == runs.size() && runReader.time() == time, "every run reads back with %u index entries", indexCapacity );
+  check( time > 0xFFFFFFFFul, "stream time passes 2^32 ms" );
+
+  // Seeking by time, around and past 2^32 ms.
+  std::vector< unsigned long > targets;
+  targets.push_back( 0 );
+  targets.push_back( 0xFFFFFFFFul );
+  targets.push_back( 0x100000000ul );
+  targets.push_back( 4000000000ul );
+  targets.push_back( 4500000000ul );
+  targets.push_back( 6000000000ul );
+  targets.push_back( time - 1 );
+  for ( unsigned int idx = 0; idx < 50; ++idx )
+  {
+    targets.push_back( static_cast< unsigned long >( random() ) * 4 % time );
+  }
+
+  for ( size_t idx = 0; idx < targets.size(); ++idx )
+  {
+    const unsigned long target = targets[ idx ];
+    const size_t run = std::upper_bound( startTimes.begin(), startTimes.end(), target ) - startTimes.begin() - 1;
+    const bool sought = runReader.seekTime( target );
+    const unsigned long start = runReader.time();
+    check( sought && runReader.readRun( duration ) && start == startTimes[ run ] && duration == runs[ run ],
+           "seekTime( %lu ) lands on the run starting at %lu, not %lu", target, startTimes[ run ], start );
+  }
+  check( !runReader.seekTime( time ), "seekTime() past the end fails" );
+
+  // Seeking by character.
+  for ( unsigned int idx = 0; idx < 50; ++idx )
+  {
+    const unsigned long target = idx == 0 ? 0 : idx == 1 ? text.size() - 1 : random() % text.size();
+    check( reader.seekCharacter( target ) && reader.character() == target && reader.readCharacter() == text[ target ],
+           "seekCharacter( %lu ) with %u index entries", target, indexCapacity );
+  }
+}
+
+static void checkVersion( Check & check )
+{
+  MemoryStream stream;
+  MorseStreamWriter writer( stream, 0, 0 );
+  writer.begin();
+  writer.addCharacter( 'E' );
+  writer.finish();
+
+  stream.bytes[ 4 ] = 1;
+  MorseStreamReader reader( stream );
+  check( !reader.open(), "version 1 streams are rejected" );
+}
+
+static void checkMetadataLength( Check & check )
+{
+  MemoryStream stream;
+  MorseStreamWriter writer( stream, 0, 0 );
+  writer.setSource( "a source long enough to overwrite" );
+  writer.begin();
+  writer.addCharacter( 'E' );
+  writer.finish();
+
+  // The source record's length, made too big for 64 bits, with the metadata ended just after it.
+  const unsigned int offset = MorseStream::HEADER_LENGTH + 1;
+  std::memset( stream.bytes.data() + offset, 0x80, MorseStream::VARINT_LENGTH - 1 );
+  stream.bytes[ offset + MorseStream::VARINT_LENGTH - 1 ] = 0x02;
+  stream.bytes[ offset + MorseStream::VARINT_LENGTH ] = MorseStream::META_END;
+  MorseStreamReader reader( stream );
+  check( !reader.open(), "metadata length over 64 bits is rejected" );
+}
+
+int main()
+{
+  Check check( "streamcheck" );
+
+  checkFields( check );
+  checkStream( check, 0 );
+  checkStream( check, 4 );     // Small enough that the stride doubles several times.
+  checkStream( check, 1024 );  // Every chunk indexed.
+  checkVersion( check );
+  checkMetadataLength( check );
+
+  return check.finish();
+}
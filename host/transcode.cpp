@@ -0,0 +1,616 @@
+/*
+  transcode.cpp
+
+  Command line Morse code transcoder. Reads text, dot/dash notation (see notation.h), Morse stream
+  files (see morsestream.h), or audio, and writes text, Morse stream files, or audio. Runs as a four
+  stage pipeline, one thread per stage:
+
+    reader -> codec -> renderer -> writer
+
+  The reader fills batches from the input; stream files come in already split into symbols and key
+  timing, and the codec passes them straight on. The codec encodes text into Morse code and key
+  timing, decoding notation into text first, or detects key timing in audio. The renderer turns key
+  timing into audio, stream files, or text decoded by MorseToAscii. The writer empties batches to the
+  output. Stages hand batches to each other by pointer over bounded lock-free queues, and empty
+  batches go back upstream for reuse.
+
+  Usage: transcode [-i text|notation|stream|pcm] [-o text|stream|pcm] [-r rate] [-f frequency] [input [output]]
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/types.h>
+#include "audio.h"
+#include "keying.h"
+#include "morsestream.h"
+#include "notation.h"
+#include "spscqueue.h"
+
+// Typedefs
+enum Format { TEXT, NOTATION, STREAM, PCM };
+
+struct Options
+{
+  Format       input;
+  Format       output;
+  unsigned int sampleRate;
+  double       frequency;
+  const char * inputPath;
+  const char * outputPath;
+};
+
+// Unit of work passed between stages.
+struct Batch
+{
+  std::vector< unsigned char > bytes;    // Input, or output ready for the writer.
+  std::vector< unsigned char > symbols;  // MorseStream::Symbol values.
+  std::vector< unsigned long > runs;     // Key down / key up durations in milliseconds.
+  bool                         end;      // Last batch of the job.
+};
+
+typedef SpscQueue< Batch * > BatchQueue;
+
+// Constants
+static const size_t batchSize = 1 << 20;   // bytes
+static const size_t streamBatchLength = 1 << 16;  // Codewords and runs read from a stream file per batch.
+static const size_t batchCount = 4;        // per ring
+static const size_t indexCapacity = 1 << 16;
+
+// Set by any stage that fails. The pipeline still runs to the end, so no stage is left waiting.
+static std::atomic< bool > failed( false );
+
+// Appends stream file bytes to the renderer's output batch.
+class BatchSink : public MorseStreamSink
+{
+  public:
+  BatchSink() : batch( 0 ) {}
+
+  virtual bool write( const unsigned char * const data, const unsigned int length )
+  {
+    batch->bytes.insert( batch->bytes.end(), data, data + length );
+    return true;
+  }
+
+  Batch * batch;
+};
+
+// Reads a stream file from disk. The file has to be seekable, since readers jump to the index and back.
+class FileSource : public MorseStreamSource
+{
+  public:
+  FileSource( std::FILE * const file ) : file( file ) {}
+
+  virtual bool read( unsigned char * const data, const unsigned int length )
+  {
+    return std::fread( data, 1, length, file ) == length;
+  }
+
+  virtual bool seek( const unsigned long offset )
+  {
+    return fseeko( file, static_cast< off_t >( offset ), SEEK_SET ) == 0;
+  }
+
+  virtual unsigned long size()
+  {
+    if ( fseeko( file, 0, SEEK_END ) != 0 )
+    {
+      return 0;
+    }
+    const off_t end = ftello( file );
+    return end < 0 ? 0 : static_cast< unsigned long >( end );
+  }
+
+  private:
+  std::FILE * const file;
+};
+
+// reader()
+// Fills batches from the input file.
+static void reader( std::FILE * const input, BatchQueue & freeBatches, BatchQueue & toCodec )
+{
+  for ( ;; )
+  {
+    Batch * const batch = freeBatches.pop();
+
+    batch->bytes.resize( batchSize );
+    const size_t length = std::fread( batch->bytes.data(), 1, batchSize, input );
+    batch->bytes.resize( length );
+    batch->end = length < batchSize;
+
+    if ( std::ferror( input ) )
+    {
+      std::perror( "transcode: read" );
+      failed = true;
+    }
+
+    // Once it's pushed, the batch belongs to the codec, and may be back in the reader's hands refilled.
+    const bool end = batch->end;
+    toCodec.push( batch );
+    if ( end )
+    {
+      return;
+    }
+  }
+}
+
+// streamReader()
+// Fills batches with the symbols and runs of a stream file. Streams that hold codewords but no timing
+// are keyed at the standard speed, as AsciiToMorse would send them.
+static void streamReader( std::FILE * const input, BatchQueue & freeBatches, BatchQueue & toCodec )
+{
+  // One reader for symbols and one for runs, since each keeps its own place in the chunks.
+  FileSource source( input );
+  MorseStreamReader symbolReader( source );
+  MorseStreamReader runReader( source );
+  bool opened = symbolReader.open() && runReader.open();
+  if ( !opened )
+  {
+    std::fprintf( stderr, "transcode: input isn't a seekable Morse stream file\n" );
+    failed = true;
+  }
+
+  unsigned long duration = 0;
+  bool moreSymbols = opened;
+  bool moreRuns = opened && runReader.readRun( duration );
+  const bool timed = moreRuns;
+  KeyingSchedule schedule;
+
+  for ( ;; )
+  {
+    Batch * const batch = freeBatches.pop();
+    batch->bytes.clear();
+    batch->symbols.clear();
+    batch->runs.clear();
+
+    for ( size_t count = 0; moreSymbols && count < streamBatchLength; ++count )
+    {
+      Morse::MorseCodeElement codeword[ Morse::SEQUENCE_LENGTH ];
+      bool wordSpace;
+      moreSymbols = symbolReader.readCodeword( codeword, wordSpace );
+      if ( !moreSymbols )
+      {
+        break;
+      }
+
+      // Codewords are SPACE terminated. Write them back out as the symbols they were stored as.
+      if ( wordSpace )
+      {
+        batch->symbols.push_back( MorseStream::END_OF_WORD );
+      }
+      else
+      {
+        for ( unsigned int idx = 0; idx < Morse::SEQUENCE_LENGTH && codeword[ idx ] != Morse::SPACE; ++idx )
+        {
+          batch->symbols.push_back( static_cast< unsigned char >( codeword[ idx ] ) );
+        }
+        batch->symbols.push_back( MorseStream::END_OF_CHARACTER );
+      }
+    }
+
+    if ( timed )
+    {
+      for ( size_t count = 0; moreRuns && count < streamBatchLength; ++count )
+      {
+        batch->runs.push_back( duration );
+        moreRuns = runReader.readRun( duration );
+      }
+    }
+    else
+    {
+      for ( size_t idx = 0; idx < batch->symbols.size(); ++idx )
+      {
+        schedule.add( static_cast< MorseStream::Symbol >( batch->symbols[ idx ] ), batch->runs );
+      }
+    }
+
+    batch->end = !moreSymbols && !moreRuns;
+    if ( batch->end && !timed )
+    {
+      schedule.finish( batch->runs );
+    }
+
+    const bool end = batch->end;
+    toCodec.push( batch );
+    if ( end )
+    {
+      return;
+    }
+  }
+}
+
+// codec()
+// Encodes text into symbols and runs, or detects runs in audio.
+static void codec( const Options & options, BatchQueue & fromReader, BatchQueue & toRenderer )
+{
+  KeyingSchedule schedule;
+  EnvelopeDetector detector( options.sampleRate );
+  NotationDecoder notation;
+  std::vector< char > text;
+
+  for ( ;; )
+  {
+    Batch * const batch = fromReader.pop();
+    if ( options.input == STREAM )
+    {
+      // The reader already split the stream into symbols and runs.
+      const bool end = batch->end;
+      toRenderer.push( batch );
+      if ( end )
+      {
+        return;
+      }
+      continue;
+    }
+
+    batch->symbols.clear();
+    batch->runs.clear();
+
+    if ( options.input != PCM )
+    {
+      const char * characters = reinterpret_cast< const char * >( batch->bytes.data() );
+      size_t length = batch->bytes.size();
+      if ( options.input == NOTATION )
+      {
+        text.resize( length + 1 );
+        length = notation.decode( characters, length, text.data() );
+        if ( batch->end )
+        {
+          length += notation.finish( text.data() + length );
+        }
+        characters = text.data();
+      }
+
+      for ( size_t idx = 0; idx < length; ++idx )
+      {
+        // Line breaks and tabs separate words as well as SPACE does.
+        const char character = std::isspace( static_cast< unsigned char >( characters[ idx ] ) ) ? ' ' : characters[ idx ];
+        schedule.addCharacter( character, batch->symbols, batch->runs );
+      }
+
+      if ( batch->end )
+      {
+        schedule.finish( batch->runs );
+      }
+    }
+    else
+    {
+      detector.addBytes( batch->bytes.data(), batch->bytes.size(), batch->runs );
+
+      if ( batch->end )
+      {
+        detector.finish( batch->runs );
+      }
+    }
+
+    const bool end = batch->end;
+    toRenderer.push( batch );
+    if ( end )
+    {
+      return;
+    }
+  }
+}
+
+// handOff()
+// Passes a full output batch to the writer. Unless it's the last, takes an empty one in its place.
+static void handOff( Batch * & output, const bool end, BatchQueue & freeOutput, BatchQueue & toWriter )
+{
+  output->end = end;
+  toWriter.push( output );
+
+  if ( !end )
+  {
+    output = freeOutput.pop();
+    output->bytes.clear();
+  }
+}
+
+// renderer()
+// Turns symbols and runs into the output format.
+static void renderer( const Options & options,
+                      BatchQueue & fromCodec, BatchQueue & freeInput,
+                      BatchQueue & freeOutput, BatchQueue & toWriter )
+{
+  ToneRenderer tone( options.sampleRate, options.frequency, 0.5, 5.0 );
+  RunDecoder decoder;
+  std::string text;
+  Morse::MorseCodeElement codeword[ Morse::SEQUENCE_LENGTH ];
+  unsigned int codewordLength = 0;
+
+  std::vector< MorseStream::IndexEntry > index( indexCapacity );
+  BatchSink sink;
+  MorseStreamWriter stream( sink, index.data(), indexCapacity );
+
+  Batch * output = freeOutput.pop();
+  output->bytes.clear();
+  sink.batch = output;
+
+  if ( options.output == STREAM )
+  {
+    stream.setDotDuration( Morse::DOT_DURATION );
+    stream.setSource( options.input == TEXT ? "transcode text" :
+                      options.input == NOTATION ? "transcode notation" :
+                      options.input == STREAM ? "transcode stream" : "transcode pcm" );
+    stream.begin();
+  }
+
+  for ( ;; )
+  {
+    Batch * const batch = fromCodec.pop();
+    const bool end = batch->end;
+    text.clear();
+
+    switch ( options.output )
+    {
+      case PCM:
+        // Audio is far bigger than the text it came from, so hand it on as it fills up.
+        for ( size_t idx = 0; idx < batch->runs.size(); ++idx )
+        {
+          tone.add( batch->runs[ idx ], output->bytes );
+          if ( output->bytes.size() >= batchSize )
+          {
+            handOff( output, false, freeOutput, toWriter );
+            sink.batch = output;
+          }
+        }
+        break;
+      case TEXT:
+        decoder.add( batch->runs.data(), batch->runs.size(), text );
+        if ( end )
+        {
+          decoder.finish( text );
+        }
+        output->bytes.insert( output->bytes.end(), text.begin(), text.end() );
+        break;
+      case STREAM:
+        // Encoded text brings its symbols along. Audio has to be decoded for them.
+        for ( size_t idx = 0; idx < batch->symbols.size(); ++idx )
+        {
+          const MorseStream::Symbol symbol = static_cast< MorseStream::Symbol >( batch->symbols[ idx ] );
+          if ( symbol == MorseStream::END_OF_WORD )
+          {
+            stream.addWordSpace();
+          }
+          else if ( symbol == MorseStream::END_OF_CHARACTER )
+          {
+            for ( unsigned int lp = codewordLength; lp < Morse::SEQUENCE_LENGTH; ++lp )
+            {
+              codeword[ lp ] = Morse::SPACE;
+            }
+            stream.addCodeword( codeword );
+            codewordLength = 0;
+          }
+          else if ( codewordLength < Morse::SEQUENCE_LENGTH )
+          {
+            codeword[ codewordLength++ ] = static_cast< Morse::MorseCodeElement >( symbol );
+          }
+        }
+
+        for ( size_t idx = 0; idx < batch->runs.size(); ++idx )
+        {
+          stream.addRun( batch->runs[ idx ] );
+        }
+        if ( options.input == PCM )
+        {
+          decoder.add( batch->runs.data(), batch->runs.size(), text );
+          if ( end )
+          {
+            decoder.finish( text );
+          }
+        }
+        for ( size_t idx = 0; idx < text.size(); ++idx )
+        {
+          stream.addCharacter( text[ idx ] );
+        }
+        if ( end )
+        {
+          stream.finish();
+        }
+        break;
+      case NOTATION:
+        // Input only.
+        break;
+    }
+
+    // The input batch is done with. Hand it back to the reader.
+    if ( !end )
+    {
+      freeInput.push( batch );
+    }
+
+    if ( end )
+    {
+      handOff( output, true, freeOutput, toWriter );
+      return;
+    }
+    if ( output->bytes.size() >= batchSize )
+    {
+      handOff( output, false, freeOutput, toWriter );
+      sink.batch = output;
+    }
+  }
+}
+
+// writer()
+// Empties batches to the output file.
+static void writer( std::FILE * const outputFile, BatchQueue & fromRenderer, BatchQueue & freeBatches )
+{
+  for ( ;; )
+  {
+    Batch * const batch = fromRenderer.pop();
+
+    if ( !batch->bytes.empty() &&
+         std::fwrite( batch->bytes.data(), 1, batch->bytes.size(), outputFile ) != batch->bytes.size() )
+    {
+      if ( !failed.exchange( true ) )
+      {
+        std::perror( "transcode: write" );
+      }
+    }
+
+    if ( batch->end )
+    {
+      return;
+    }
+    freeBatches.push( batch );
+  }
+}
+
+// parseFormat()
+// Returns false if name isn't a format.
+static bool parseFormat( const char * const name, Format & format )
+{
+  if ( std::strcmp( name, "text" ) == 0 )
+  {
+    format = TEXT;
+  }
+  else if ( std::strcmp( name, "notation" ) == 0 )
+  {
+    format = NOTATION;
+  }
+  else if ( std::strcmp( name, "stream" ) == 0 )
+  {
+    format = STREAM;
+  }
+  else if ( std::strcmp( name, "pcm" ) == 0 )
+  {
+    format = PCM;
+  }
+  else
+  {
+    return false;
+  }
+
+  return true;
+}
+
+static int usage()
+{
+  std::fprintf( stderr,
+                "usage: transcode [-i text|notation|stream|pcm] [-o text|stream|pcm] [-r rate] [-f frequency] [input [output]]\n"
+                "  Text is encoded to Morse code; notation (\".- -... / -.-.\") is decoded to text first;\n"
+                "  stream files are played back from their key timing; pcm (16-bit little endian mono) is decoded.\n"
+                "  Defaults: -i text -o pcm -r 8000 -f 600, standard input and output.\n" );
+  return 2;
+}
+
+int main( int argc, char * argv[] )
+{
+  Options options = { TEXT, PCM, 8000, 600.0, 0, 0 };
+
+  int arg = 1;
+  for ( ; arg < argc && argv[ arg ][ 0 ] == '-' && argv[ arg ][ 1 ] != 0; ++arg )
+  {
+    if ( arg + 1 >= argc )
+    {
+      return usage();
+    }
+
+    const char * const value = argv[ ++arg ];
+    switch ( argv[ arg - 1 ][ 1 ] )
+    {
+      case 'i':
+        if ( !parseFormat( value, options.input ) )
+        {
+          return usage();
+        }
+        break;
+      case 'o':
+        if ( !parseFormat( value, options.output ) || options.output == NOTATION )
+        {
+          return usage();
+        }
+        break;
+      case 'r':
+        options.sampleRate = std::strtoul( value, 0, 10 );
+        break;
+      case 'f':
+        options.frequency = std::strtod( value, 0 );
+        break;
+      default:
+        return usage();
+    }
+  }
+
+  if ( options.sampleRate == 0 || options.frequency <= 0.0 || options.frequency * 2 >= options.sampleRate )
+  {
+    std::fprintf( stderr, "transcode: frequency must be below half the sample rate\n" );
+    return 2;
+  }
+
+  if ( arg < argc )
+  {
+    options.inputPath = argv[ arg++ ];
+  }
+  if ( arg < argc )
+  {
+    options.outputPath = argv[ arg++ ];
+  }
+  if ( arg < argc )
+  {
+    return usage();
+  }
+
+  std::FILE * const input = ( options.inputPath == 0 || std::strcmp( options.inputPath, "-" ) == 0 ) ?
+                            stdin : std::fopen( options.inputPath, "rb" );
+  if ( input == 0 )
+  {
+    std::perror( options.inputPath );
+    return 1;
+  }
+
+  std::FILE * const output = ( options.outputPath == 0 || std::strcmp( options.outputPath, "-" ) == 0 ) ?
+                             stdout : std::fopen( options.outputPath, "wb" );
+  if ( output == 0 )
+  {
+    std::perror( options.outputPath );
+    return 1;
+  }
+
+  // Two rings of batches: input batches cycle reader -> codec -> renderer -> reader, and output batches
+  // cycle renderer -> writer -> renderer.
+  std::vector< Batch > batches( 2 * batchCount );
+  BatchQueue freeInput( batchCount ), toCodec( batchCount ), toRenderer( batchCount );
+  BatchQueue freeOutput( batchCount ), toWriter( batchCount );
+  for ( size_t idx = 0; idx < batchCount; ++idx )
+  {
+    freeInput.push( &batches[ idx ] );
+    freeOutput.push( &batches[ batchCount + idx ] );
+  }
+
+  std::thread readerThread( options.input == STREAM ? streamReader : reader, input, std::ref( freeInput ), std::ref( toCodec ) );
+  std::thread codecThread( codec, std::cref( options ), std::ref( toCodec ), std::ref( toRenderer ) );
+  std::thread rendererThread( renderer, std::cref( options ),
+                              std::ref( toRenderer ), std::ref( freeInput ),
+                              std::ref( freeOutput ), std::ref( toWriter ) );
+  std::thread writerThread( writer, output, std::ref( toWriter ), std::ref( freeOutput ) );
+
+  readerThread.join();
+  codecThread.join();
+  rendererThread.join();
+  writerThread.join();
+
+  if ( std::fflush( output ) != 0 || ( output != stdout && std::fclose( output ) != 0 ) )
+  {
+    std::perror( "transcode: write" );
+    failed = true;
+  }
+  if ( input != stdin )
+  {
+    std::fclose( input );
+  }
+
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,143 @@
+/*
+  keyer.cpp
+
+  Class to turn a pair of iambic paddles into perfectly timed Morse code elements.
+    
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/ 
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <WProgram.h>
+#include "keyer.h"
+
+IambicKeyer::IambicKeyer() :
+  state( IDLE ),
+  mode( IAMBIC_B ),
+  dotDuration( Morse::DOT_DURATION ),
+  stateStart( 0 ),
+  stateDuration( 0 ),
+  current( Morse::DOT ),
+  ditMemory( false ),
+  dahMemory( false ),
+  ditWasDown( false ),
+  dahWasDown( false )
+{
+}
+
+void IambicKeyer::setMode( const Mode keyerMode )
+{
+  mode = keyerMode;
+}
+
+void IambicKeyer::setDotDuration( const unsigned long duration )
+{
+  dotDuration = duration;
+}
+
+bool IambicKeyer::sample( const unsigned long & now, const int ditLevel, const int dahLevel )
+{
+  const bool ditDown = ditLevel == LOW;
+  const bool dahDown = dahLevel == LOW;
+  bool elementSent = false;
+  
+  switch ( state )
+  {
+    case IDLE:
+      if ( ditDown )
+      {
+        // Squeezes start with a DOT.
+        start( now, Morse::DOT );
+      }
+      else if ( dahDown )
+      {
+        start( now, Morse::DASH );
+      }
+      break;
+    case SENDING:
+      remember( ditDown, dahDown );
+      if ( now - stateStart >= stateDuration )
+      {
+        // Element over. Key up for the space between elements.
+        elementSent = true;
+        stateStart += stateDuration;
+        stateDuration = dotDuration;
+        state = SPACING;
+      }
+      break;
+    case SPACING:
+      remember( ditDown, dahDown );
+      if ( now - stateStart >= stateDuration )
+      {
+        // The other element goes first, so a squeeze alternates.
+        const bool ditNext = ditMemory || ditDown;
+        const bool dahNext = dahMemory || dahDown;
+        const Morse::MorseCodeElement other = current == Morse::DOT ? Morse::DASH : Morse::DOT;
+        if ( other == Morse::DOT ? ditNext : dahNext )
+        {
+          start( stateStart + stateDuration, other );
+        }
+        else if ( current == Morse::DOT ? ditNext : dahNext )
+        {
+          start( stateStart + stateDuration, current );
+        }
+        else
+        {
+          state = IDLE;
+        }
+      }
+      break;
+    default:
+      // This should never happen.
+      state = IDLE;
+      break;
+  }
+  
+  ditWasDown = ditDown;
+  dahWasDown = dahDown;
+  return elementSent;
+}
+
+bool IambicKeyer::keyed() const
+{
+  return state == SENDING;
+}
+
+Morse::MorseCodeElement IambicKeyer::element() const
+{
+  return current;
+}
+
+void IambicKeyer::remember( const bool ditDown, const bool dahDown )
+{
+  // Iambic B remembers the other paddle whenever it is down, so letting go of a squeeze still sends
+  // the next element. Iambic A only remembers a fresh press, not a paddle held through the element.
+  if ( current == Morse::DASH && ditDown && ( mode == IAMBIC_B || !ditWasDown ) )
+  {
+    ditMemory = true;
+  }
+  if ( current == Morse::DOT && dahDown && ( mode == IAMBIC_B || !dahWasDown ) )
+  {
+    dahMemory = true;
+  }
+}
+
+void IambicKeyer::start( const unsigned long & now, const Morse::MorseCodeElement key )
+{
+  current = key;
+  stateStart = now;
+  stateDuration = key == Morse::DOT ? dotDuration : 3 * dotDuration;
+  state = SENDING;
+  
+  // Whatever was remembered is being sent now.
+  if ( key == Morse::DOT )
+  {
+    ditMemory = false;
+  }
+  else
+  {
+    dahMemory = false;
+  }
+}
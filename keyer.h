@@ -0,0 +1,109 @@
+/*
+  keyer.h
+
+  Class to turn a pair of iambic paddles into perfectly timed Morse code elements. Holding the dit
+  paddle sends a string of DOTs, holding the dah paddle a string of DASHes, and squeezing both sends
+  them alternately. A paddle tapped while the keyer is busy is remembered, and its element sent next.
+
+  In Iambic A mode, letting go of a squeeze finishes the element being sent, and stops. In Iambic B
+  mode, it finishes the element, and sends one more of the other kind.
+    
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/ 
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#ifndef KEYER_H
+#define KEYER_H
+
+#include "morse.h"
+
+class IambicKeyer
+{
+  public:
+  //
+  // Types
+  //
+  
+  enum Mode { IAMBIC_A, IAMBIC_B };
+  
+  // Constructor
+  IambicKeyer();
+  
+  // setMode()
+  // Arguments:
+  //   keyerMode - IAMBIC_A or IAMBIC_B. Defaults to IAMBIC_B.
+  void setMode( const Mode keyerMode );
+  
+  // setDotDuration()
+  // Arguments:
+  //   duration - Length of a DOT in milliseconds. A DASH is three DOTs, and the space between elements
+  //              is one. Defaults to Morse::DOT_DURATION.
+  void setDotDuration( const unsigned long duration );
+  
+  // sample()
+  // Arguments:
+  //   now - Time in milliseconds since startup.
+  //   ditLevel - Level read from the dit paddle pin. The paddle pulls it LOW.
+  //   dahLevel - Level read from the dah paddle pin.
+  // Returns:
+  //   true when an element has just been sent, and element() holds which one.
+  // Feed the keyer a sample of the paddles. This function should be called every time the loop()
+  // function is executed.
+  bool sample( const unsigned long & now, const int ditLevel, const int dahLevel );
+  
+  // keyed()
+  // Returns:
+  //   true while an element is being sent.
+  bool keyed() const;
+  
+  // element()
+  // Returns:
+  //   DOT or DASH, the element being sent or last sent.
+  Morse::MorseCodeElement element() const;
+  
+  private:
+  // State machine:
+  //
+  // +------+  paddle: key down   +---------+
+  // | IDLE |-------------------->| SENDING |
+  // +------+                     +---------+
+  //    ^                           ^     |
+  //    |          paddle or memory:|     | element over:
+  //    |                  key down |     | key up
+  //    |                           |     V
+  //    |   no paddle, no memory   +---------+
+  //    +--------------------------| SPACING |
+  //                               +---------+
+  //
+  enum State { IDLE, SENDING, SPACING };
+  
+  State                   state;
+  Mode                    mode;
+  unsigned long           dotDuration;
+  unsigned long           stateStart;     // Time the current element or space started.
+  unsigned long           stateDuration;  // Length of the current element or space.
+  Morse::MorseCodeElement current;
+  bool                    ditMemory;
+  bool                    dahMemory;
+  bool                    ditWasDown;
+  bool                    dahWasDown;
+  
+  // remember()
+  // Arguments:
+  //   ditDown - dit paddle is pressed.
+  //   dahDown - dah paddle is pressed.
+  // Latches presses of the paddle for the other element while the keyer is busy.
+  void remember( const bool ditDown, const bool dahDown );
+  
+  // start()
+  // Arguments:
+  //   now - Time in milliseconds since startup.
+  //   key - DOT or DASH.
+  // Keys down for an element.
+  void start( const unsigned long & now, const Morse::MorseCodeElement key );
+};
+
+#endif
@@ -0,0 +1,140 @@
+/*
+  keyinput.cpp
+
+  Class to debounce the Morse key switch, and time how long it is held down.
+    
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/ 
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <WProgram.h>
+#include "keyinput.h"
+#include "morse.h"
+
+KeyInput::KeyInput() :
+  keyState( KEY_UP ),
+  previousLevel( HIGH ),
+  rawEdgeTime( 0 ),
+  lockoutStart( 0 ),
+  keyDownTime( 0 ),
+  duration( 0 ),
+  dot( Morse::DOT_DURATION ),
+  lockoutWindow( Morse::DOT_DURATION / 4 ),
+  edges( 0 ),
+  bounces( 0 ),
+  bounceTime( 0 )
+{
+}
+
+bool KeyInput::sample( const unsigned long & now, const int level )
+{
+  bool keyAvailable = false;
+  const bool lockedOut = edges != 0 && now - lockoutStart < lockoutWindow;
+  
+  if ( level != previousLevel )
+  {
+    rawEdgeTime = now;
+    
+    if ( lockedOut )
+    {
+      // Contacts still settling.
+      ++bounces;
+      if ( now - lockoutStart > bounceTime )
+      {
+        bounceTime = now - lockoutStart;
+      }
+    }
+  }
+  previousLevel = level;
+  
+  if ( lockedOut )
+  {
+    return false;
+  }
+  
+  // The level can have changed for good inside the lockout window. Time the edge from when it did.
+  if ( level == LOW && keyState == KEY_UP )
+  {
+    // Key pressed.
+    keyDownTime = rawEdgeTime;
+    keyState = KEY_DOWN;
+    lockoutStart = now;
+    ++edges;
+  }
+  else if ( level == HIGH && keyState == KEY_DOWN )
+  {
+    // Key released.
+    duration = rawEdgeTime - keyDownTime;
+    keyAvailable = true;
+    keyState = KEY_UP;
+    lockoutStart = now;
+    ++edges;
+    track( duration );
+  }
+  
+  return keyAvailable;
+}
+
+KeyInput::KeyState KeyInput::state() const
+{
+  return keyState;
+}
+
+unsigned long KeyInput::keyDuration() const
+{
+  return duration;
+}
+
+unsigned long KeyInput::lockout() const
+{
+  return lockoutWindow;
+}
+
+unsigned long KeyInput::dotEstimate() const
+{
+  return dot;
+}
+
+unsigned long KeyInput::edgeCount() const
+{
+  return edges;
+}
+
+unsigned long KeyInput::bounceCount() const
+{
+  return bounces;
+}
+
+unsigned long KeyInput::longestBounce() const
+{
+  return bounceTime;
+}
+
+void KeyInput::track( const unsigned long mark )
+{
+  if ( mark < dot / 3 )
+  {
+    // Too short to be a dot, even from a sender twice as fast. Probably noise, so leave the estimate alone.
+    return;
+  }
+  
+  // Anything under two dots is a dot. Anything longer is a dash, three dots long.
+  const unsigned long length = mark < 2 * dot ? mark : mark / 3;
+  
+  // Follow a speed-up quickly. Until the estimate is under half a fast sender's dashes, they pass for
+  // dots, and would drag it the wrong way.
+  dot = length < dot ? ( dot + length ) / 2 : ( 3 * dot + length ) / 4;
+  
+  lockoutWindow = dot / 4;
+  if ( lockoutWindow < MIN_LOCKOUT )
+  {
+    lockoutWindow = MIN_LOCKOUT;
+  }
+  else if ( lockoutWindow > MAX_LOCKOUT )
+  {
+    lockoutWindow = MAX_LOCKOUT;
+  }
+}
@@ -0,0 +1,107 @@
+/*
+  keyinput.h
+
+  Class to debounce the Morse key switch, and time how long it is held down.
+
+  The debouncer acts on the first edge it sees, so it adds no delay to the keying, and then ignores
+  the level for a lockout window while the contacts settle. The window follows the sender's speed: a
+  quarter of a dot, as estimated from recent keypresses, between MIN_LOCKOUT and MAX_LOCKOUT. Bounces
+  it ignores are counted, so a worn or dirty key shows up in the statistics. The sketch decodes at the
+  estimated speed too: loop() hands it to MorseToAscii::setDotDuration() and Morse::classifyMark().
+    
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/ 
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#ifndef KEYINPUT_H
+#define KEYINPUT_H
+
+class KeyInput
+{
+  public:
+  //
+  // Types
+  //
+  
+  enum KeyState { KEY_DOWN, KEY_UP };
+  
+  //
+  // Constants
+  //
+  
+  // Limits on the lockout window, in milliseconds.
+  static const unsigned long MIN_LOCKOUT = 5;
+  static const unsigned long MAX_LOCKOUT = 25;
+  
+  // Constructor
+  KeyInput();
+  
+  // sample()
+  // Arguments:
+  //   now - Time in milliseconds since startup.
+  //   level - Level read from the key pin. The key pulls it LOW.
+  // Returns:
+  //   true when the key has been released, and keyDuration() holds how long it was down.
+  // Feed the key input a sample of the key pin. This function should be called every time the loop()
+  // function is executed.
+  bool sample( const unsigned long & now, const int level );
+  
+  // state()
+  // Returns:
+  //   Debounced state of the key.
+  KeyState state() const;
+  
+  // keyDuration()
+  // Returns:
+  //   How long the key was held down, in milliseconds, the last time it was released.
+  unsigned long keyDuration() const;
+  
+  // lockout()
+  // Returns:
+  //   Current lockout window, in milliseconds.
+  unsigned long lockout() const;
+  
+  // dotEstimate()
+  // Returns:
+  //   Estimated length of the sender's dots, in milliseconds.
+  unsigned long dotEstimate() const;
+  
+  // edgeCount()
+  // Returns:
+  //   Number of edges accepted since startup.
+  unsigned long edgeCount() const;
+  
+  // bounceCount()
+  // Returns:
+  //   Number of changes in level ignored inside lockout windows since startup.
+  unsigned long bounceCount() const;
+  
+  // longestBounce()
+  // Returns:
+  //   Longest time from an accepted edge to the last bounce after it, in milliseconds.
+  unsigned long longestBounce() const;
+  
+  private:
+  KeyState      keyState;
+  int           previousLevel;
+  unsigned long rawEdgeTime;      // Time of the last change in level.
+  unsigned long lockoutStart;     // Time the last edge was accepted.
+  unsigned long keyDownTime;      // Time the key went down.
+  unsigned long duration;
+  unsigned long dot;              // Estimated dot length.
+  unsigned long lockoutWindow;
+  unsigned long edges;
+  unsigned long bounces;
+  unsigned long bounceTime;
+  
+  // track()
+  // Arguments:
+  //   mark - How long the key was just held down, in milliseconds.
+  // Updates the dot estimate and lockout window.
+  void track( const unsigned long mark );
+};
+
+#endif
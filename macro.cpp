@@ -0,0 +1,590 @@
+/*
+  macro.cpp
+
+  Message macros kept in EEPROM.
+    
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/ 
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <WProgram.h>
+#include "macro.h"
+#include "outputqueue.h"
+
+#if defined( __AVR__ )
+#include <avr/eeprom.h>
+
+static bool eepromReady()
+{
+  return eeprom_is_ready();
+}
+
+static unsigned char eepromRead( const unsigned int address )
+{
+  return eeprom_read_byte( reinterpret_cast< const uint8_t * >( address ) );
+}
+
+static void eepromWrite( const unsigned int address, const unsigned char value )
+{
+  eeprom_write_byte( reinterpret_cast< uint8_t * >( address ), value );
+}
+
+#else
+// No EEPROM. Keep it in RAM, starting out erased like a new chip's. A write takes as long as the chip's
+// on the virtual clock, and a read during one moves the clock on to its end, as eeprom_read_byte()
+// waits for it.
+static const unsigned long eepromWriteTime = 3300;  // microseconds
+static unsigned char       eeprom[ MacroStore::SLOT_COUNT * MacroStore::SLOT_LENGTH ];
+static bool                eepromErased = false;
+static bool                eepromWriting = false;
+static unsigned long       eepromWriteStart = 0;
+
+static bool eepromReady()
+{
+  if ( eepromWriting && micros() - eepromWriteStart >= eepromWriteTime )
+  {
+    eepromWriting = false;
+  }
+  return !eepromWriting;
+}
+
+static unsigned char eepromRead( const unsigned int address )
+{
+  if ( !eepromReady() )
+  {
+    hostSetTime( eepromWriteStart + eepromWriteTime );
+    eepromWriting = false;
+  }
+  return eepromErased ? eeprom[ address ] : 0xFF;
+}
+
+static void eepromWrite( const unsigned int address, const unsigned char value )
+{
+  if ( !eepromErased )
+  {
+    for ( unsigned int idx = 0; idx < sizeof( eeprom ); ++idx )
+    {
+      eeprom[ idx ] = 0xFF;
+    }
+    eepromErased = true;
+  }
+  eeprom[ address ] = value;
+  eepromWriting = true;
+  eepromWriteStart = micros();
+}
+
+#endif
+
+//
+// MacroStore
+//
+
+MacroStore::MacroStore() :
+  messageSlot( 0 ),
+  count( 0 ),
+  storing( false ),
+  writing( false ),
+  step( 0 ),
+  repeatWrites( 0 )
+{
+  for ( unsigned int idx = 0; idx < SLOT_LENGTH; ++idx )
+  {
+    message[ idx ] = 0;
+  }
+  for ( unsigned int idx = 0; idx < SLOT_COUNT; ++idx )
+  {
+    repeats[ idx ] = 0;
+  }
+}
+
+bool MacroStore::begin( const unsigned int slot )
+{
+  if ( slot >= SLOT_COUNT || writing )
+  {
+    return false;
+  }
+  
+  for ( unsigned int idx = 0; idx < SLOT_LENGTH; ++idx )
+  {
+    message[ idx ] = 0;
+  }
+  messageSlot = slot;
+  count = 0;
+  storing = true;
+  
+  // The message's header clears the repeat anyway.
+  repeatWrites &= ~( 0x03 << ( 2 * slot ) );
+  return true;
+}
+
+bool MacroStore::addChar( const char character )
+{
+  if ( !storing )
+  {
+    return false;
+  }
+  
+  if ( character == ' ' )
+  {
+    // SPACE is a special case.
+    return addSymbol( MorseStream::END_OF_WORD );
+  }
+  
+  Morse::MorseCodeElement codeword[ Morse::SEQUENCE_LENGTH ];
+  if ( !Morse::asciiToMorse( character, codeword ) )
+  {
+    // Skip it.
+    return true;
+  }
+  
+  // Store the whole character or none of it.
+  unsigned int length = 0;
+  while ( length < Morse::SEQUENCE_LENGTH && codeword[ length ] != Morse::SPACE )
+  {
+    ++length;
+  }
+  if ( count + length + 1 > SYMBOL_CAPACITY )
+  {
+    return false;
+  }
+  
+  for ( unsigned int idx = 0; idx < length; ++idx )
+  {
+    addSymbol( static_cast< MorseStream::Symbol >( codeword[ idx ] ) );
+  }
+  return addSymbol( MorseStream::END_OF_CHARACTER );
+}
+
+void MacroStore::end()
+{
+  if ( !storing )
+  {
+    return;
+  }
+  
+  // Header, with no repeat.
+  message[ 0 ] = static_cast< unsigned char >( count & 0xFF );
+  message[ 1 ] = static_cast< unsigned char >( count >> 8 );
+  message[ 2 ] = 0;
+  message[ 3 ] = 0;
+  
+  storing = false;
+  writing = true;
+  step = 0;
+}
+
+bool MacroStore::setRepeat( const unsigned int slot, const unsigned int seconds )
+{
+  if ( slot >= SLOT_COUNT || busy( slot ) )
+  {
+    return false;
+  }
+  
+  repeats[ slot ] = seconds;
+  repeatWrites |= 0x03 << ( 2 * slot );
+  return true;
+}
+
+void MacroStore::service()
+{
+  if ( !eepromReady() )
+  {
+    return;
+  }
+  
+  if ( !writing )
+  {
+    // Repeat intervals, a byte at a time, once any message is written.
+    for ( unsigned int bit = 0; bit < 2 * SLOT_COUNT; ++bit )
+    {
+      if ( repeatWrites & ( 1 << bit ) )
+      {
+        const unsigned int slot = bit / 2;
+        const unsigned int value = bit % 2 == 0 ? repeats[ slot ] & 0xFF : repeats[ slot ] >> 8;
+        writeByte( slot * SLOT_LENGTH + 2 + bit % 2, static_cast< unsigned char >( value ) );
+        repeatWrites &= ~( 1 << bit );
+        break;
+      }
+    }
+    return;
+  }
+  
+  // Writes go in three parts: mark the slot empty, write the symbols, then write the header.
+  const unsigned int symbolBytes = ( count + 3 ) / 4;
+  unsigned int offset;
+  unsigned char value;
+  
+  if ( step < 2 )
+  {
+    offset = step;
+    value = 0xFF;
+  }
+  else if ( step < 2 + symbolBytes )
+  {
+    offset = HEADER_LENGTH + step - 2;
+    value = message[ offset ];
+  }
+  else
+  {
+    // Repeat, then symbol count.
+    offset = ( step - 2 - symbolBytes + 2 ) % HEADER_LENGTH;
+    value = message[ offset ];
+  }
+  
+  writeByte( messageSlot * SLOT_LENGTH + offset, value );
+  
+  if ( ++step == 2 + symbolBytes + HEADER_LENGTH )
+  {
+    writing = false;
+  }
+}
+
+bool MacroStore::busy( const unsigned int slot ) const
+{
+  return ( storing || writing ) && slot == messageSlot;
+}
+
+bool MacroStore::ready() const
+{
+  return eepromReady();
+}
+
+unsigned int MacroStore::symbolCount( const unsigned int slot ) const
+{
+  if ( slot >= SLOT_COUNT || busy( slot ) )
+  {
+    return 0;
+  }
+  
+  const unsigned int symbols = readWord( slot * SLOT_LENGTH );
+  return symbols <= SYMBOL_CAPACITY ? symbols : 0;
+}
+
+unsigned int MacroStore::repeat( const unsigned int slot ) const
+{
+  if ( symbolCount( slot ) == 0 )
+  {
+    return 0;
+  }
+  
+  if ( repeatWrites & ( 0x03 << ( 2 * slot ) ) )
+  {
+    // Not all written yet.
+    return repeats[ slot ];
+  }
+  return readWord( slot * SLOT_LENGTH + 2 );
+}
+
+MorseStream::Symbol MacroStore::symbol( const unsigned int slot, const unsigned int index ) const
+{
+  const unsigned char packed = eepromRead( slot * SLOT_LENGTH + HEADER_LENGTH + index / 4 );
+  return static_cast< MorseStream::Symbol >( ( packed >> ( 2 * ( index % 4 ) ) ) & 0x03 );
+}
+
+bool MacroStore::addSymbol( const MorseStream::Symbol symbol )
+{
+  if ( count >= SYMBOL_CAPACITY )
+  {
+    return false;
+  }
+  
+  message[ HEADER_LENGTH + count / 4 ] |= static_cast< unsigned char >( symbol << ( 2 * ( count % 4 ) ) );
+  ++count;
+  return true;
+}
+
+void MacroStore::writeByte( const unsigned int address, const unsigned char value )
+{
+  if ( eepromRead( address ) != value )
+  {
+    eepromWrite( address, value );
+  }
+}
+
+unsigned int MacroStore::readWord( const unsigned int address )
+{
+  return eepromRead( address ) | ( static_cast< unsigned int >( eepromRead( address + 1 ) ) << 8 );
+}
+
+//
+// MacroPlayer
+//
+
+MacroPlayer::MacroPlayer( const MacroStore & macros ) :
+  store( macros ),
+  state( IDLE ),
+  outputLine( 13 ),
+  slot( 0 ),
+  count( 0 ),
+  position( 0 ),
+  eventStart( 0 ),
+  eventDuration( 0 ),
+  inCharacter( false )
+{
+}
+
+void MacroPlayer::setOutputLine( const int line )
+{
+  outputLine = line;
+}
+
+bool MacroPlayer::play( const unsigned int macroSlot, const unsigned long & now )
+{
+  stop();
+  
+  count = store.symbolCount( macroSlot );
+  if ( count == 0 )
+  {
+    return false;
+  }
+  
+  slot = macroSlot;
+  position = 0;
+  inCharacter = false;
+  space( now );
+  
+  // No space before the first element.
+  eventDuration = 0;
+  return true;
+}
+
+void MacroPlayer::stop()
+{
+  if ( state == KEY_DOWN )
+  {
+    digitalWrite( outputLine, LOW );
+  }
+  state = IDLE;
+}
+
+bool MacroPlayer::playing() const
+{
+  return state != IDLE;
+}
+
+bool MacroPlayer::keyed() const
+{
+  return state == KEY_DOWN;
+}
+
+void MacroPlayer::timestamp( const unsigned long & now )
+{
+  if ( state == IDLE )
+  {
+    return;
+  }
+  
+  if ( store.busy( slot ) )
+  {
+    // Being stored over. What's left of it is gone.
+    stop();
+    return;
+  }
+  
+  // Elapsed time, so that it still works when millis() wraps.
+  if ( now - eventStart < eventDuration )
+  {
+    return;
+  }
+  
+  if ( !store.ready() )
+  {
+    // Reading the symbols would wait for the EEPROM write to finish. Try again next time around.
+    return;
+  }
+  
+  switch ( state )
+  {
+    case KEY_DOWN:
+      // Element is finished.
+      digitalWrite( outputLine, LOW );
+      space( eventStart + eventDuration );
+      break;
+    case KEY_UP:
+      if ( position < count )
+      {
+        // space() stopped on an element. Key it.
+        const MorseStream::Symbol element = store.symbol( slot, position++ );
+        digitalWrite( outputLine, HIGH );
+        eventStart += eventDuration;
+        eventDuration = element == MorseStream::DOT ? Morse::DOT_DURATION : Morse::DASH_DURATION;
+        inCharacter = true;
+        state = KEY_DOWN;
+      }
+      else if ( store.repeat( slot ) != 0 )
+      {
+        // Beacon. Wait, then go again.
+        eventStart += eventDuration;
+        eventDuration = 1000UL * store.repeat( slot );
+        state = REPEAT;
+      }
+      else
+      {
+        state = IDLE;
+      }
+      break;
+    case REPEAT:
+      // play() sets eventStart, so start from a copy.
+      if ( play( slot, static_cast< unsigned long >( eventStart + eventDuration ) ) )
+      {
+        // Key the first element now, not next time around.
+        timestamp( now );
+      }
+      break;
+    default:
+      state = IDLE;
+      break;
+  }
+}
+
+void MacroPlayer::space( const unsigned long & from )
+{
+  // Same timing as AsciiToMorse: KEY_SPACE after every element, LETTER_SPACE after the last one of a
+  // character, and the rest of WORD_SPACE on top for an ASCII SPACE.
+  unsigned long duration = Morse::KEY_SPACE_DURATION;
+  
+  while ( position < count )
+  {
+    const MorseStream::Symbol symbol = store.symbol( slot, position );
+    if ( symbol == MorseStream::END_OF_CHARACTER )
+    {
+      if ( inCharacter )
+      {
+        duration = Morse::LETTER_SPACE_DURATION;
+        inCharacter = false;
+      }
+    }
+    else if ( symbol == MorseStream::END_OF_WORD )
+    {
+      duration += Morse::WORD_SPACE_DURATION - Morse::KEY_SPACE_DURATION;
+    }
+    else
+    {
+      break;
+    }
+    ++position;
+  }
+  
+  eventStart = from;
+  eventDuration = duration;
+  state = KEY_UP;
+}
+
+//
+// MacroCommand
+//
+
+MacroCommand::MacroCommand( MacroStore & macros, MacroPlayer & player ) :
+  store( macros ),
+  player( player ),
+  command( 0 ),
+  slot( -1 ),
+  argument( 0 ),
+  lineEnded( false )
+{
+}
+
+bool MacroCommand::addChar( const char character, const unsigned long & now )
+{
+  const bool endOfLine = character == '\r' || character == '\n';
+  
+  if ( lineEnded && character == '\n' )
+  {
+    // Second half of a CRLF that already ended a command. It isn't text.
+    lineEnded = false;
+    return true;
+  }
+  lineEnded = false;
+  
+  if ( command == 0 )
+  {
+    if ( character != '#' )
+    {
+      return false;
+    }
+    command = '#';
+    slot = -1;
+    argument = 0;
+  }
+  else if ( endOfLine )
+  {
+    run( now );
+    command = 0;
+    lineEnded = character == '\r';
+  }
+  else if ( command == '#' )
+  {
+    command = character >= 'a' && character <= 'z' ? character - 'a' + 'A' : character;
+  }
+  else if ( slot < 0 && command != 'X' )
+  {
+    slot = character - '0';
+    if ( command == 'S' && !store.begin( slot ) )
+    {
+      serialOutput.println( "( MacroCommand::addChar() ) ERROR: slot not available." );
+      command = '!';
+    }
+  }
+  else if ( command == '!' )
+  {
+    // Ignore the rest of the line.
+  }
+  else if ( command == 'S' )
+  {
+    if ( !store.addChar( character ) )
+    {
+      serialOutput.println( "( MacroCommand::addChar() ) ERROR: macro full." );
+      command = '!';
+    }
+  }
+  else if ( character >= '0' && character <= '9' )
+  {
+    // Repeat intervals are 2 bytes in EEPROM. Anything bigger would wrap.
+    const unsigned int digit = character - '0';
+    if ( argument > ( 0xFFFF - digit ) / 10 )
+    {
+      serialOutput.println( "( MacroCommand::addChar() ) ERROR: bad macro command." );
+      command = '!';
+    }
+    else
+    {
+      argument = argument * 10 + digit;
+    }
+  }
+  
+  return true;
+}
+
+void MacroCommand::run( const unsigned long & now )
+{
+  bool ok = true;
+  
+  switch ( command )
+  {
+    case 'S':
+    case '!':
+      // Keep what fit.
+      store.end();
+      break;
+    case 'P':
+      ok = slot >= 0 && player.play( slot, now );
+      break;
+    case 'R':
+      ok = slot >= 0 && store.setRepeat( slot, argument );
+      break;
+    case 'X':
+      player.stop();
+      break;
+    default:
+      ok = false;
+      break;
+  }
+  
+  if ( !ok )
+  {
+    serialOutput.println( "( MacroCommand::addChar() ) ERROR: bad macro command." );
+  }
+}
@@ -0,0 +1,269 @@
+/*
+  macro.h
+
+  Message macros kept in EEPROM. Each slot holds a message already encoded into Morse code symbols, so
+  playing it back is only a matter of timing: no characters to queue, and nothing to look up. Slots can
+  repeat after an interval, to run a beacon with no host attached.
+
+  Slot layout, SLOT_LENGTH bytes each, multi-byte values little endian:
+
+    symbol count  2 bytes  EMPTY when the slot has never been stored.
+    repeat        2 bytes  Seconds between the end of one playback and the start of the next. 0 for none.
+    symbols       up to SYMBOL_CAPACITY MorseStream::Symbol values, 2 bits each, four to a byte, first
+                  symbol in the low bits, as in Morse stream files (see morsestream.h).
+
+  Writing EEPROM takes over 3 ms a byte, and the sketch can't wait that long in loop(). A message is
+  encoded into RAM as it arrives, then written out a byte at a time by service() whenever the EEPROM is
+  ready. The symbol count goes last, so a slot is never played half written. New repeat intervals are
+  written the same way, after any message.
+    
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/ 
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#ifndef MACRO_H
+#define MACRO_H
+
+#include "morsestream.h"
+
+class MacroStore
+{
+  public:
+  //
+  // Constants
+  //
+  
+  static const unsigned int SLOT_COUNT = 4;
+  static const unsigned int SLOT_LENGTH = 256;  // bytes of EEPROM
+  static const unsigned int HEADER_LENGTH = 4;
+  static const unsigned int SYMBOL_BYTES = SLOT_LENGTH - HEADER_LENGTH;
+  static const unsigned int SYMBOL_CAPACITY = 4 * SYMBOL_BYTES;
+  static const unsigned int EMPTY = 0xFFFF;     // Symbol count of erased EEPROM.
+  
+  // Constructor
+  MacroStore();
+  
+  // begin()
+  // Arguments:
+  //   slot - Slot to store a message in.
+  // Returns:
+  //   false if the slot doesn't exist, or the last message is still being written.
+  // Starts storing a message. Its repeat interval is cleared.
+  bool begin( const unsigned int slot );
+  
+  // addChar()
+  // Arguments:
+  //   character - Next ASCII character of the message.
+  // Returns:
+  //   false if the message is full. Characters that can't be sent in Morse code are skipped, as
+  //   AsciiToMorse skips them.
+  bool addChar( const char character );
+  
+  // end()
+  // Ends the message, and starts writing it to EEPROM.
+  void end();
+  
+  // setRepeat()
+  // Arguments:
+  //   slot - Slot to change.
+  //   seconds - Pause between playbacks. 0 to play once.
+  // Returns:
+  //   false if the slot doesn't exist, or is being written.
+  // repeat() returns the new interval straight away. service() writes it to EEPROM.
+  bool setRepeat( const unsigned int slot, const unsigned int seconds );
+  
+  // service()
+  // Writes the next byte of a stored message or repeat interval, if the EEPROM is ready for it. This
+  // function should be called every time the loop() function is executed.
+  void service();
+  
+  // busy()
+  // Arguments:
+  //   slot - Slot to check.
+  // Returns:
+  //   true while a message is being stored in slot, or written to it.
+  bool busy( const unsigned int slot ) const;
+  
+  // ready()
+  // Returns:
+  //   false while a byte is being written to EEPROM. Reading EEPROM then waits for the write to finish.
+  bool ready() const;
+  
+  // symbolCount()
+  // Arguments:
+  //   slot - Slot to check.
+  // Returns:
+  //   Number of symbols in the slot. 0 if it is empty, doesn't exist, or is busy.
+  unsigned int symbolCount( const unsigned int slot ) const;
+  
+  // repeat()
+  // Arguments:
+  //   slot - Slot to check.
+  // Returns:
+  //   Seconds between playbacks, or 0 to play once.
+  unsigned int repeat( const unsigned int slot ) const;
+  
+  // symbol()
+  // Arguments:
+  //   slot - Slot to read.
+  //   index - Symbol to read, less than symbolCount( slot ).
+  MorseStream::Symbol symbol( const unsigned int slot, const unsigned int index ) const;
+  
+  private:
+  // Message being stored, laid out as in EEPROM.
+  unsigned char message[ SLOT_LENGTH ];
+  unsigned int  messageSlot;
+  unsigned int  count;
+  bool          storing;   // Characters are being added.
+  bool          writing;   // Waiting to be written to EEPROM.
+  unsigned int  step;      // Next write. See service().
+  
+  // Repeat intervals waiting to be written, and a bit for each of their bytes still to go: bits 0 and 1
+  // for slot 0, 2 and 3 for slot 1, and so on.
+  unsigned int  repeats[ SLOT_COUNT ];
+  unsigned char repeatWrites;
+  
+  // writeByte()
+  // Arguments:
+  //   address - EEPROM address.
+  //   value - Byte to write there.
+  // Skips the write if the byte already holds the value. Writing wears EEPROM out.
+  static void writeByte( const unsigned int address, const unsigned char value );
+  
+  // addSymbol()
+  // Arguments:
+  //   symbol - Next symbol of the message.
+  // Returns:
+  //   false if the message is full.
+  bool addSymbol( const MorseStream::Symbol symbol );
+  
+  // readWord()
+  // Arguments:
+  //   address - EEPROM address of a 2-byte value.
+  static unsigned int readWord( const unsigned int address );
+};
+
+class MacroPlayer
+{
+  public:
+  // Constructor
+  // Arguments:
+  //   macros - Where the macros are stored.
+  MacroPlayer( const MacroStore & macros );
+  
+  // setOutputLine()
+  // Arguments:
+  //   line - Pin number to use as the output line.
+  // Configures which digital pin to key. Usually the one AsciiToMorse keys.
+  void setOutputLine( const int line );
+  
+  // play()
+  // Arguments:
+  //   slot - Slot to play.
+  //   now - Time in milliseconds since startup.
+  // Returns:
+  //   false if the slot is empty or busy.
+  // Starts playing a slot, stopping whatever was playing.
+  bool play( const unsigned int slot, const unsigned long & now );
+  
+  // stop()
+  // Stops playing, and drops the output line.
+  void stop();
+  
+  // playing()
+  // Returns:
+  //   true while a slot is playing, or waiting to repeat.
+  bool playing() const;
+
+  
+  // keyed()
+  // Returns:
+  //   true while the output line is raised for a DOT or DASH.
+  bool keyed() const;
+  
+  // timestamp()
+  // Arguments:
+  //   now - Time in milliseconds since startup.
+  // Notify the player of passage of time. This function should be called every time the loop()
+  // function is executed. Playback stops if the slot starts being stored over. While the EEPROM is being
+  // written, whatever is due waits for the next call, rather than wait for the write. Elements stay on
+  // the DOT grid; each one starts at most one write late.
+  void timestamp( const unsigned long & now );
+  
+  private:
+  // State machine:
+  //
+  //              play()
+  // +------+ ----------------> +--------+  element over: drop output   +----------+
+  // | IDLE |                   | KEY_UP | <--------------------------- | KEY_DOWN |
+  // +------+ <---------------- +--------+ ---------------------------> +----------+
+  //           symbols done,     |     ^      space over: raise output
+  //           no repeat         |     | repeat interval over
+  //                             V     |
+  //                           +--------+
+  //                           | REPEAT |
+  //                           +--------+
+  //
+  enum State { IDLE, KEY_DOWN, KEY_UP, REPEAT };
+  
+  const MacroStore & store;
+  State              state;
+  int                outputLine;
+  unsigned int       slot;
+  unsigned int       count;
+  unsigned int       position;        // Next symbol to play.
+  unsigned long      eventStart;      // When the current state started.
+  unsigned long      eventDuration;   // How long it lasts, in milliseconds.
+  bool               inCharacter;     // An element has been keyed since the last end of character.
+  
+  // space()
+  // Arguments:
+  //   from - Time the space started.
+  // Enters KEY_UP, and works out how long the space lasts from the symbols up to the next element.
+  void space( const unsigned long & from );
+};
+
+// Macro commands from the serial port, a character at a time:
+//   #S<slot><text>     Store text in a slot.
+//   #P<slot>           Play a slot.
+//   #R<slot><seconds>  Repeat a slot after a pause, as a beacon. The first slot with a repeat
+//                      starts playing at power up. 0 seconds to play once, 65535 at most.
+//   #X                 Stop playing.
+// Commands end at a carriage return or line feed, or both. Errors are reported on serialOutput.
+class MacroCommand
+{
+  public:
+  // Constructor
+  // Arguments:
+  //   macros - Where to store messages.
+  //   player - What to play them with.
+  MacroCommand( MacroStore & macros, MacroPlayer & player );
+  
+  // addChar()
+  // Arguments:
+  //   character - Next character from the serial port.
+  //   now - Time in milliseconds since startup.
+  // Returns:
+  //   true if the character was part of a command, and shouldn't be sent as Morse code. '#' can't be,
+  //   anyway.
+  bool addChar( const char character, const unsigned long & now );
+  
+  private:
+  MacroStore &  store;
+  MacroPlayer & player;
+  char          command;    // Command letter, '#' before it arrives, '!' after an error, 0 outside a command.
+  int           slot;
+  unsigned int  argument;
+  bool          lineEnded;  // The last character was a carriage return that ended a command.
+  
+  // run()
+  // Arguments:
+  //   now - Time in milliseconds since startup.
+  // Carries out the command once its line has ended.
+  void run( const unsigned long & now );
+};
+
+#endif
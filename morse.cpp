@@ -79,7 +79,7 @@ bool Morse::asciiToMorse( const char character, MorseCodeElement * const sequenc
   else if ( character >= '0' && character <= '9' )
   {
     // Character is in the range ['0'..'9']
-    idx = static_cast< unsigned int >( character - '0' + ('Z' - 'A' ) );
+    idx = static_cast< unsigned int >( character - '0' + ( 'Z' - 'A' + 1 ) );
   }
   else
   {
@@ -106,34 +106,73 @@ bool Morse::asciiToMorse( const char character, MorseCodeElement * const sequenc
 }
 
 
-const char Morse::morseToAscii( const MorseCodeElement * const sequence )
+// Reverse of morseLookup, indexed by codeword, so decoding a character doesn't search the table. Costs
+// CODEWORD_LIMIT bytes of RAM. Built before setup() runs, once morseLookup is in place.
+class ReverseLookup
 {
-  // Step through the lookup table.
-  for ( unsigned int idx = 0; idx < sizeof( morseLookup ); ++idx )
+  public:
+  ReverseLookup()
   {
-    // Reset pointers and flags.
-    const MorseCodeElement * element = sequence;
-    const MorseCodeElement * tableElement = morseLookup[ idx ].sequence;
-    bool elementsEqual = true;
-    
-    // Compare sequences
-    for ( unsigned int lp = 0; lp < Morse::SEQUENCE_LENGTH; ++lp )
+    for ( unsigned int idx = 0; idx < Morse::CODEWORD_LIMIT; ++idx )
     {
-      if ( *element++ != *tableElement++ )
-      {
-        elementsEqual = false;
-        break;
-      }
+      characters[ idx ] = '?';
     }
     
-    if ( elementsEqual )
+    for ( unsigned int idx = 0; idx < sizeof( morseLookup ) / sizeof( morseLookup[ 0 ] ); ++idx )
     {
-      // Morse sequence found.
-      return morseLookup[ idx ].character;
+      characters[ Morse::packCodeword( morseLookup[ idx ].sequence ) ] = morseLookup[ idx ].character;
     }
   }
   
-  // Morse sequence not found.
-  return '?';
+  char characters[ Morse::CODEWORD_LIMIT ];
+};
+
+static const ReverseLookup reverseLookup;
+
+const char Morse::morseToAscii( const MorseCodeElement * const sequence )
+{
+  return codewordToAscii( packCodeword( sequence ) );
 }
 
+unsigned int Morse::packCodeword( const MorseCodeElement * const sequence )
+{
+  unsigned int codeword = 0;
+  unsigned int length = 0;
+  
+  while ( length < Morse::SEQUENCE_LENGTH && sequence[ length ] != Morse::SPACE )
+  {
+    codeword |= ( sequence[ length ] == Morse::DASH ? 1 : 0 ) << length;
+    ++length;
+  }
+  
+  // Only SPACEs may follow the end of the sequence.
+  for ( unsigned int idx = length; idx < Morse::SEQUENCE_LENGTH; ++idx )
+  {
+    if ( sequence[ idx ] != Morse::SPACE )
+    {
+      return CODEWORD_LIMIT;
+    }
+  }
+  
+  return codeword | ( 1 << length );
+}
+
+char Morse::codewordToAscii( const unsigned int codeword )
+{
+  return codeword < CODEWORD_LIMIT ? reverseLookup.characters[ codeword ] : '?';
+}
+
+Morse::MorseCodeElement Morse::classifyMark( const unsigned long duration, const unsigned long dotDuration )
+{
+  if ( duration >= Morse::DASH_THRESHOLD * dotDuration / Morse::DOT_DURATION )
+  {
+    return Morse::DASH;
+  }
+  else if ( duration >= Morse::NOISE_THRESHOLD * dotDuration / Morse::DOT_DURATION )
+  {
+    return Morse::DOT;
+  }
+  
+  // Too short. It's noise.
+  return Morse::SPACE;
+}
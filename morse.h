@@ -32,6 +32,12 @@ class Morse
   // Maximum number of elements in a Morse code sequence.
   static const unsigned int SEQUENCE_LENGTH = 5;
   
+  // Sequences pack into codewords: a bit per element, 0 for DOT and 1 for DASH, first element lowest,
+  // then a 1 bit above the last element. Every sequence of up to SEQUENCE_LENGTH elements packs into its
+  // own codeword below CODEWORD_LIMIT. EMPTY_CODEWORD has no elements.
+  static const unsigned int CODEWORD_LIMIT = 1 << ( SEQUENCE_LENGTH + 1 );
+  static const unsigned int EMPTY_CODEWORD = 1;
+  
   // Duration of signals in milliseconds.
   static const unsigned long DOT_DURATION = 100;
   static const unsigned long DASH_DURATION = 3 * DOT_DURATION;
@@ -39,6 +45,16 @@ class Morse
   static const unsigned long LETTER_SPACE_DURATION = 5 * DOT_DURATION; // 3 * DOT_DURATION
   static const unsigned long WORD_SPACE_DURATION = 9 * DOT_DURATION; // 7 * DOT_DURATION
   
+  // Thresholds for classifying received signals, in milliseconds. Each one sits halfway between the
+  // durations it tells apart, so a sender can be off by as much in either direction. A word space is
+  // told apart from the gap AsciiToMorse leaves for an ASCII SPACE, which adds to the LETTER_SPACE
+  // before it.
+  static const unsigned long NOISE_THRESHOLD = DOT_DURATION / 2;                                          // Key down
+  static const unsigned long DASH_THRESHOLD = ( DOT_DURATION + DASH_DURATION ) / 2;                      // Key down
+  static const unsigned long LETTER_SPACE_THRESHOLD = ( KEY_SPACE_DURATION + LETTER_SPACE_DURATION ) / 2; // Key up
+  static const unsigned long WORD_SPACE_THRESHOLD =
+    ( 2 * LETTER_SPACE_DURATION + WORD_SPACE_DURATION - KEY_SPACE_DURATION ) / 2;                        // Key up
+  
   //
   // Interface functions
   //
@@ -59,6 +75,28 @@ class Morse
   //   The ASCII character equivalent of the Morse code. If the Morse code cannot be
   //   converted, the function returns '?'.
   static const char morseToAscii( const MorseCodeElement * const sequence );
+  
+  // packCodeword()
+  // Arguments:
+  //   sequence - pointer to the Morse code sequence to pack.
+  // Returns:
+  //   The sequence's codeword. CODEWORD_LIMIT if the sequence has an element after a SPACE.
+  static unsigned int packCodeword( const MorseCodeElement * const sequence );
+  
+  // codewordToAscii()
+  // Arguments:
+  //   codeword - packed Morse code sequence.
+  // Returns:
+  //   The ASCII character equivalent of the codeword, or '?', in constant time.
+  static char codewordToAscii( const unsigned int codeword );
+  
+  // classifyMark()
+  // Arguments:
+  //   duration - How long the key was held down, in milliseconds.
+  //   dotDuration - Length of the sender's DOTs, in milliseconds. The thresholds scale with it.
+  // Returns:
+  //   DOT or DASH. SPACE if the keypress was too short to be either, and should be ignored as noise.
+  static MorseCodeElement classifyMark( const unsigned long duration, const unsigned long dotDuration = DOT_DURATION );
 };
 
 #endif
@@ -0,0 +1,886 @@
+/*
+  morsestream.cpp
+
+  Compact binary file format for Morse code element streams and timing runs, with a chunk index for
+  random access by character or by time offset.
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <string.h>
+#include "morsestream.h"
+
+// File signatures.
+static const unsigned char headerMagic[] = { 'M', 'O', 'R', 'S' };
+static const unsigned char trailerMagic[] = { 'M', 'I', 'D', 'X' };
+
+// Longest chunk header: tag and six varints.
+static const unsigned int chunkHeaderLength = 1 + 6 * MorseStream::VARINT_LENGTH;
+
+//
+// MorseStream
+//
+
+unsigned int MorseStream::putVarint( unsigned long value, unsigned char * const buffer )
+{
+  unsigned int length = 0;
+
+  while ( value >= 0x80 )
+  {
+    buffer[ length++ ] = static_cast< unsigned char >( value | 0x80 );
+    value >>= 7;
+  }
+  buffer[ length++ ] = static_cast< unsigned char >( value );
+
+  return length;
+}
+
+unsigned int MorseStream::getVarint( const unsigned char * const buffer, const unsigned int length, unsigned long & value )
+{
+  value = 0;
+
+  for ( unsigned int idx = 0; idx < length && idx < VARINT_LENGTH; ++idx )
+  {
+    // Bits that would land past the top of an unsigned long mean the value doesn't fit.
+    const unsigned long bits = buffer[ idx ] & 0x7F;
+    const unsigned int shift = 7 * idx;
+    if ( shift >= 8 * sizeof( unsigned long ) ? bits != 0 : ( bits << shift ) >> shift != bits )
+    {
+      return 0;
+    }
+    if ( bits != 0 )
+    {
+      value |= bits << shift;
+    }
+
+    if ( ( buffer[ idx ] & 0x80 ) == 0 )
+    {
+      return idx + 1;
+    }
+  }
+
+  // Truncated, or longer than any value we write.
+  return 0;
+}
+
+void MorseStream::putU32( const unsigned long value, unsigned char * const buffer )
+{
+  buffer[ 0 ] = static_cast< unsigned char >( value );
+  buffer[ 1 ] = static_cast< unsigned char >( value >> 8 );
+  buffer[ 2 ] = static_cast< unsigned char >( value >> 16 );
+  buffer[ 3 ] = static_cast< unsigned char >( value >> 24 );
+}
+
+unsigned long MorseStream::getU32( const unsigned char * const buffer )
+{
+  return static_cast< unsigned long >( buffer[ 0 ] ) |
+         static_cast< unsigned long >( buffer[ 1 ] ) << 8 |
+         static_cast< unsigned long >( buffer[ 2 ] ) << 16 |
+         static_cast< unsigned long >( buffer[ 3 ] ) << 24;
+}
+
+void MorseStream::putU64( const unsigned long value, unsigned char * const buffer )
+{
+  // Shifted in two steps, since shifting a 32-bit unsigned long by 32 is undefined.
+  putU32( value, buffer );
+  putU32( value >> 16 >> 16, buffer + 4 );
+}
+
+bool MorseStream::getU64( const unsigned char * const buffer, unsigned long & value )
+{
+  const unsigned long high = getU32( buffer + 4 );
+  value = getU32( buffer );
+
+  if ( high == 0 )
+  {
+    return true;
+  }
+  if ( sizeof( unsigned long ) * 8 < 64 )
+  {
+    // Too big for this platform.
+    return false;
+  }
+
+  value |= high << 16 << 16;
+  return true;
+}
+
+//
+// MorseStreamWriter
+//
+
+MorseStreamWriter::MorseStreamWriter( MorseStreamSink & sink, MorseStream::IndexEntry * const index, const unsigned int indexCapacity ) :
+  sink( sink ),
+  index( index ),
+  indexCapacity( index != 0 ? indexCapacity : 0 ),
+  indexCount( 0 ),
+  indexStride( 1 ),
+  chunkCount( 0 ),
+  offset( 0 ),
+  wpm( 0 ),
+  dotDuration( 0 ),
+  source( 0 ),
+  characterCount( 0 ),
+  time( 0 ),
+  chunkFirstCharacter( 0 ),
+  chunkStartTime( 0 ),
+  symbolCount( 0 ),
+  runCount( 0 ),
+  runBytes( 0 )
+{
+  memset( symbols, 0, sizeof( symbols ) );
+}
+
+void MorseStreamWriter::setWpm( const unsigned long wpm )
+{
+  this->wpm = wpm;
+}
+
+void MorseStreamWriter::setDotDuration( const unsigned long duration )
+{
+  dotDuration = duration;
+}
+
+void MorseStreamWriter::setSource( const char * const source )
+{
+  this->source = source;
+}
+
+bool MorseStreamWriter::begin()
+{
+  unsigned char header[ MorseStream::HEADER_LENGTH ] =
+  {
+    headerMagic[ 0 ], headerMagic[ 1 ], headerMagic[ 2 ], headerMagic[ 3 ],
+    MorseStream::VERSION,
+    static_cast< unsigned char >( indexCapacity > 0 ? MorseStream::FLAG_INDEXED : 0 )
+  };
+
+  if ( !emit( header, sizeof( header ) ) )
+  {
+    return false;
+  }
+
+  if ( wpm != 0 && !writeVarintMetadata( MorseStream::META_WPM, wpm ) )
+  {
+    return false;
+  }
+
+  if ( dotDuration != 0 && !writeVarintMetadata( MorseStream::META_DOT_DURATION, dotDuration ) )
+  {
+    return false;
+  }
+
+  if ( source != 0 &&
+       !writeMetadata( MorseStream::META_SOURCE, reinterpret_cast< const unsigned char * >( source ), strlen( source ) ) )
+  {
+    return false;
+  }
+
+  const unsigned char end = MorseStream::META_END;
+  return emit( &end, 1 );
+}
+
+bool MorseStreamWriter::addCharacter( const char character )
+{
+  if ( character == ' ' )
+  {
+    // SPACE is a special case.
+    return addWordSpace();
+  }
+
+  Morse::MorseCodeElement codeword[ Morse::SEQUENCE_LENGTH ];
+  if ( !Morse::asciiToMorse( character, codeword ) )
+  {
+    // Not Morse-legal. Skip it, just like AsciiToMorse does.
+    return true;
+  }
+
+  return addCodeword( codeword );
+}
+
+bool MorseStreamWriter::addCodeword( const Morse::MorseCodeElement * const codeword )
+{
+  // Keep codewords whole within a chunk.
+  if ( symbolCount + Morse::SEQUENCE_LENGTH + 1 > MorseStream::CHUNK_SYMBOLS && !flushChunk() )
+  {
+    return false;
+  }
+
+  for ( unsigned int idx = 0; idx < Morse::SEQUENCE_LENGTH && codeword[ idx ] != Morse::SPACE; ++idx )
+  {
+    putSymbol( static_cast< MorseStream::Symbol >( codeword[ idx ] ) );
+  }
+  putSymbol( MorseStream::END_OF_CHARACTER );
+
+  ++characterCount;
+  return true;
+}
+
+bool MorseStreamWriter::addWordSpace()
+{
+  if ( symbolCount + 1 > MorseStream::CHUNK_SYMBOLS && !flushChunk() )
+  {
+    return false;
+  }
+
+  putSymbol( MorseStream::END_OF_WORD );
+
+  ++characterCount;
+  return true;
+}
+
+bool MorseStreamWriter::addRun( const unsigned long duration )
+{
+  unsigned char encoded[ MorseStream::VARINT_LENGTH ];
+  const unsigned int length = MorseStream::putVarint( duration, encoded );
+  if ( runBytes + length > MorseStream::CHUNK_RUN_BYTES && !flushChunk() )
+  {
+    return false;
+  }
+
+  memcpy( runs + runBytes, encoded, length );
+  runBytes += length;
+  ++runCount;
+  time += duration;
+
+  return true;
+}
+
+bool MorseStreamWriter::finish()
+{
+  if ( !flushChunk() )
+  {
+    return false;
+  }
+
+  // Index.
+  const unsigned long indexOffset = offset;
+  unsigned char buffer[ MorseStream::INDEX_ENTRY_LENGTH ]; // Longest of the index header, entry, and trailer.
+
+  buffer[ 0 ] = MorseStream::INDEX_TAG;
+  MorseStream::putU32( indexStride, buffer + 1 );
+  MorseStream::putU32( indexCount, buffer + 5 );
+  if ( !emit( buffer, MorseStream::INDEX_HEADER_LENGTH ) )
+  {
+    return false;
+  }
+
+  for ( unsigned int idx = 0; idx < indexCount; ++idx )
+  {
+    MorseStream::putU64( index[ idx ].offset, buffer );
+    MorseStream::putU64( index[ idx ].firstCharacter, buffer + 8 );
+    MorseStream::putU64( index[ idx ].startTime, buffer + 16 );
+    if ( !emit( buffer, MorseStream::INDEX_ENTRY_LENGTH ) )
+    {
+      return false;
+    }
+  }
+
+  // Trailer.
+  MorseStream::putU64( indexOffset, buffer );
+  memcpy( buffer + 8, trailerMagic, sizeof( trailerMagic ) );
+  return emit( buffer, MorseStream::TRAILER_LENGTH );
+}
+
+void MorseStreamWriter::putSymbol( const MorseStream::Symbol symbol )
+{
+  symbols[ symbolCount / 4 ] |= static_cast< unsigned char >( symbol << ( 2 * ( symbolCount % 4 ) ) );
+  ++symbolCount;
+}
+
+bool MorseStreamWriter::writeMetadata( const MorseStream::MetadataTag tag, const unsigned char * const data, const unsigned int length )
+{
+  unsigned char buffer[ 1 + MorseStream::VARINT_LENGTH ];
+
+  buffer[ 0 ] = static_cast< unsigned char >( tag );
+  const unsigned int headerLength = 1 + MorseStream::putVarint( length, buffer + 1 );
+
+  return emit( buffer, headerLength ) && emit( data, length );
+}
+
+bool MorseStreamWriter::writeVarintMetadata( const MorseStream::MetadataTag tag, const unsigned long value )
+{
+  unsigned char buffer[ MorseStream::VARINT_LENGTH ];
+
+  return writeMetadata( tag, buffer, MorseStream::putVarint( value, buffer ) );
+}
+
+bool MorseStreamWriter::flushChunk()
+{
+  if ( symbolCount == 0 && runCount == 0 )
+  {
+    // Nothing to write.
+    return true;
+  }
+
+  const unsigned int symbolBytes = ( symbolCount + 3 ) / 4;
+
+  // Build the header fields first, so the chunk length can be written ahead of them.
+  unsigned char fields[ 5 * MorseStream::VARINT_LENGTH ];
+  unsigned int fieldLength = 0;
+  fieldLength += MorseStream::putVarint( chunkFirstCharacter, fields + fieldLength );
+  fieldLength += MorseStream::putVarint( chunkStartTime, fields + fieldLength );
+  fieldLength += MorseStream::putVarint( symbolCount, fields + fieldLength );
+  fieldLength += MorseStream::putVarint( runCount, fields + fieldLength );
+  fieldLength += MorseStream::putVarint( runBytes, fields + fieldLength );
+
+  unsigned char header[ 1 + MorseStream::VARINT_LENGTH ];
+  header[ 0 ] = MorseStream::CHUNK_TAG;
+  const unsigned int headerLength = 1 + MorseStream::putVarint( fieldLength + symbolBytes + runBytes, header + 1 );
+
+  recordChunk();
+
+  if ( !emit( header, headerLength ) ||
+       !emit( fields, fieldLength ) ||
+       !emit( symbols, symbolBytes ) ||
+       !emit( runs, runBytes ) )
+  {
+    return false;
+  }
+
+  // Start a new chunk.
+  ++chunkCount;
+  chunkFirstCharacter = characterCount;
+  chunkStartTime = time;
+  symbolCount = 0;
+  runCount = 0;
+  runBytes = 0;
+  memset( symbols, 0, sizeof( symbols ) );
+
+  return true;
+}
+
+void MorseStreamWriter::recordChunk()
+{
+  if ( indexCapacity == 0 || chunkCount % indexStride != 0 )
+  {
+    return;
+  }
+
+  if ( indexCount == indexCapacity )
+  {
+    // Out of room. Keep every other entry, and index half as often from now on.
+    for ( unsigned int idx = 0; 2 * idx < indexCount; ++idx )
+    {
+      index[ idx ] = index[ 2 * idx ];
+    }
+    indexCount = ( indexCount + 1 ) / 2;
+    indexStride *= 2;
+
+    if ( chunkCount % indexStride != 0 )
+    {
+      return;
+    }
+  }
+
+  index[ indexCount ].offset = offset;
+  index[ indexCount ].firstCharacter = chunkFirstCharacter;
+  index[ indexCount ].startTime = chunkStartTime;
+  ++indexCount;
+}
+
+bool MorseStreamWriter::emit( const unsigned char * const data, const unsigned int length )
+{
+  if ( length == 0 )
+  {
+    return true;
+  }
+
+  if ( !sink.write( data, length ) )
+  {
+    return false;
+  }
+
+  offset += length;
+  return true;
+}
+
+//
+// MorseStreamReader
+//
+
+MorseStreamReader::MorseStreamReader( MorseStreamSource & source ) :
+  stream( source ),
+  wpmValue( 0 ),
+  dotDurationValue( 0 ),
+  firstChunk( 0 ),
+  indexOffset( 0 ),
+  indexCount( 0 ),
+  nextChunk( 0 ),
+  characterCount( 0 ),
+  timeCount( 0 ),
+  symbolCount( 0 ),
+  symbolReadPoint( 0 ),
+  runCount( 0 ),
+  runReadPoint( 0 ),
+  runBytes( 0 ),
+  runByteReadPoint( 0 )
+{
+  sourceValue[ 0 ] = 0;
+}
+
+bool MorseStreamReader::open()
+{
+  const unsigned long size = stream.size();
+  unsigned char buffer[ MorseStream::INDEX_ENTRY_LENGTH ]; // Longest of the headers, metadata values, and trailer.
+
+  if ( size < MorseStream::HEADER_LENGTH + 1 + MorseStream::INDEX_HEADER_LENGTH + MorseStream::TRAILER_LENGTH )
+  {
+    return false;
+  }
+
+  // Header.
+  if ( !stream.seek( 0 ) || !stream.read( buffer, MorseStream::HEADER_LENGTH ) )
+  {
+    return false;
+  }
+  if ( memcmp( buffer, headerMagic, sizeof( headerMagic ) ) != 0 || buffer[ 4 ] != MorseStream::VERSION )
+  {
+    return false;
+  }
+
+  // Metadata.
+  unsigned long position = MorseStream::HEADER_LENGTH;
+  for ( ;; )
+  {
+    unsigned char tag;
+    if ( !stream.read( &tag, 1 ) )
+    {
+      return false;
+    }
+    ++position;
+
+    if ( tag == MorseStream::META_END )
+    {
+      break;
+    }
+
+    // Read the length one byte at a time; the record data follows it directly.
+    unsigned char lengthBytes[ MorseStream::VARINT_LENGTH ];
+    unsigned int lengthSize = 0;
+    unsigned long length = 0;
+    do
+    {
+      if ( lengthSize == MorseStream::VARINT_LENGTH || !stream.read( lengthBytes + lengthSize, 1 ) )
+      {
+        return false;
+      }
+    } while ( ( lengthBytes[ lengthSize++ ] & 0x80 ) != 0 );
+    if ( MorseStream::getVarint( lengthBytes, lengthSize, length ) == 0 )
+    {
+      return false;
+    }
+    position += lengthSize;
+
+    if ( tag == MorseStream::META_SOURCE )
+    {
+      // Keep as much of the description as fits.
+      const unsigned int kept = length < MorseStream::SOURCE_LENGTH ? length : MorseStream::SOURCE_LENGTH - 1;
+      if ( !stream.read( reinterpret_cast< unsigned char * >( sourceValue ), kept ) )
+      {
+        return false;
+      }
+      sourceValue[ kept ] = 0;
+    }
+    else if ( tag == MorseStream::META_WPM || tag == MorseStream::META_DOT_DURATION )
+    {
+      unsigned long value;
+      if ( length > MorseStream::VARINT_LENGTH ||
+           !stream.read( buffer, length ) ||
+           MorseStream::getVarint( buffer, length, value ) == 0 )
+      {
+        return false;
+      }
+      if ( tag == MorseStream::META_WPM )
+      {
+        wpmValue = value;
+      }
+      else
+      {
+        dotDurationValue = value;
+      }
+    }
+    // else an unknown tag from a newer writer. Skip it.
+
+    position += length;
+    if ( !stream.seek( position ) )
+    {
+      return false;
+    }
+  }
+  firstChunk = position;
+
+  // Trailer and index.
+  if ( !stream.seek( size - MorseStream::TRAILER_LENGTH ) || !stream.read( buffer, MorseStream::TRAILER_LENGTH ) )
+  {
+    return false;
+  }
+  if ( memcmp( buffer + 8, trailerMagic, sizeof( trailerMagic ) ) != 0 ||
+       !MorseStream::getU64( buffer, indexOffset ) )
+  {
+    return false;
+  }
+
+  if ( indexOffset < firstChunk ||
+       !stream.seek( indexOffset ) ||
+       !stream.read( buffer, MorseStream::INDEX_HEADER_LENGTH ) ||
+       buffer[ 0 ] != MorseStream::INDEX_TAG )
+  {
+    return false;
+  }
+  indexCount = MorseStream::getU32( buffer + 5 );
+  if ( indexOffset + MorseStream::INDEX_HEADER_LENGTH + indexCount * MorseStream::INDEX_ENTRY_LENGTH + MorseStream::TRAILER_LENGTH != size )
+  {
+    return false;
+  }
+
+  // Nothing loaded yet. The first read picks up the first chunk.
+  nextChunk = firstChunk;
+  characterCount = 0;
+  timeCount = 0;
+  symbolCount = symbolReadPoint = 0;
+  runCount = runReadPoint = 0;
+  runBytes = runByteReadPoint = 0;
+
+  return true;
+}
+
+unsigned long MorseStreamReader::wpm() const
+{
+  return wpmValue;
+}
+
+unsigned long MorseStreamReader::dotDuration() const
+{
+  return dotDurationValue;
+}
+
+const char * MorseStreamReader::source() const
+{
+  return sourceValue;
+}
+
+bool MorseStreamReader::seekCharacter( const unsigned long character )
+{
+  ChunkHeader header;
+  if ( !findChunk( false, character, header ) || !loadChunk( header ) )
+  {
+    return false;
+  }
+
+  // Skip the characters of the chunk that come before the target.
+  while ( characterCount < character )
+  {
+    if ( symbolReadPoint >= symbolCount )
+    {
+      if ( !loadNextChunk() )
+      {
+        return false;
+      }
+      continue;
+    }
+
+    const MorseStream::Symbol symbol = peekSymbol();
+    ++symbolReadPoint;
+    if ( symbol == MorseStream::END_OF_CHARACTER || symbol == MorseStream::END_OF_WORD )
+    {
+      ++characterCount;
+    }
+  }
+
+  return true;
+}
+
+bool MorseStreamReader::seekTime( const unsigned long time )
+{
+  ChunkHeader header;
+  if ( !findChunk( true, time, header ) || !loadChunk( header ) )
+  {
+    return false;
+  }
+
+  // Skip the runs of the chunk that end at or before the target.
+  for ( ;; )
+  {
+    if ( runReadPoint >= runCount )
+    {
+      if ( !loadNextChunk() )
+      {
+        return false;
+      }
+      continue;
+    }
+
+    unsigned long duration;
+    const unsigned int length = MorseStream::getVarint( runs + runByteReadPoint, runBytes - runByteReadPoint, duration );
+    if ( length == 0 )
+    {
+      return false;
+    }
+    if ( timeCount + duration > time )
+    {
+      return true;
+    }
+
+    runByteReadPoint += length;
+    ++runReadPoint;
+    timeCount += duration;
+  }
+}
+
+bool MorseStreamReader::readCodeword( Morse::MorseCodeElement * const codeword, bool & wordSpace )
+{
+  // Find a chunk with symbols left in it.
+  while ( symbolReadPoint >= symbolCount )
+  {
+    if ( !loadNextChunk() )
+    {
+      return false;
+    }
+  }
+
+  for ( unsigned int idx = 0; idx < Morse::SEQUENCE_LENGTH; ++idx )
+  {
+    codeword[ idx ] = Morse::SPACE;
+  }
+
+  wordSpace = peekSymbol() == MorseStream::END_OF_WORD;
+  if ( wordSpace )
+  {
+    ++symbolReadPoint;
+    ++characterCount;
+    return true;
+  }
+
+  // Writers keep codewords whole within a chunk, so the terminator is in this one.
+  unsigned int elements = 0;
+  while ( symbolReadPoint < symbolCount )
+  {
+    const MorseStream::Symbol symbol = peekSymbol();
+    ++symbolReadPoint;
+
+    if ( symbol == MorseStream::END_OF_CHARACTER )
+    {
+      break;
+    }
+    if ( symbol == MorseStream::END_OF_WORD || elements == Morse::SEQUENCE_LENGTH )
+    {
+      // Malformed.
+      return false;
+    }
+    codeword[ elements++ ] = static_cast< Morse::MorseCodeElement >( symbol );
+  }
+
+  ++characterCount;
+  return true;
+}
+
+char MorseStreamReader::readCharacter()
+{
+  Morse::MorseCodeElement codeword[ Morse::SEQUENCE_LENGTH ];
+  bool wordSpace;
+
+  if ( !readCodeword( codeword, wordSpace ) )
+  {
+    return 0;
+  }
+
+  return wordSpace ? ' ' : Morse::morseToAscii( codeword );
+}
+
+bool MorseStreamReader::readRun( unsigned long & duration )
+{
+  // Find a chunk with runs left in it.
+  while ( runReadPoint >= runCount )
+  {
+    if ( !loadNextChunk() )
+    {
+      return false;
+    }
+  }
+
+  const unsigned int length = MorseStream::getVarint( runs + runByteReadPoint, runBytes - runByteReadPoint, duration );
+  if ( length == 0 )
+  {
+    return false;
+  }
+
+  runByteReadPoint += length;
+  ++runReadPoint;
+  timeCount += duration;
+
+  return true;
+}
+
+unsigned long MorseStreamReader::character() const
+{
+  return characterCount;
+}
+
+unsigned long MorseStreamReader::time() const
+{
+  return timeCount;
+}
+
+bool MorseStreamReader::readHeader( const unsigned long offset, ChunkHeader & header )
+{
+  if ( offset >= indexOffset )
+  {
+    // Past the last chunk.
+    return false;
+  }
+
+  unsigned char buffer[ chunkHeaderLength ];
+  const unsigned long available = indexOffset - offset;
+  const unsigned int length = available < chunkHeaderLength ? available : chunkHeaderLength;
+
+  if ( !stream.seek( offset ) || !stream.read( buffer, length ) || buffer[ 0 ] != MorseStream::CHUNK_TAG )
+  {
+    return false;
+  }
+
+  // Tag, chunk length, then the fields the length counts.
+  unsigned long chunkLength;
+  unsigned long * const fields[] =
+  {
+    &header.firstCharacter, &header.startTime, &header.symbolCount, &header.runCount, &header.runBytes
+  };
+  unsigned int position = 1;
+  unsigned int fieldLength = MorseStream::getVarint( buffer + position, length - position, chunkLength );
+  if ( fieldLength == 0 )
+  {
+    return false;
+  }
+  position += fieldLength;
+  const unsigned int fieldsStart = position;
+
+  for ( unsigned int idx = 0; idx < sizeof( fields ) / sizeof( fields[ 0 ] ); ++idx )
+  {
+    fieldLength = MorseStream::getVarint( buffer + position, length - position, *fields[ idx ] );
+    if ( fieldLength == 0 )
+    {
+      return false;
+    }
+    position += fieldLength;
+  }
+
+  header.offset = offset;
+  header.data = offset + position;
+  header.next = offset + fieldsStart + chunkLength;
+
+  // Sanity check against the buffers, and against the chunk length.
+  const unsigned long symbolBytes = ( header.symbolCount + 3 ) / 4;
+  return header.symbolCount <= MorseStream::CHUNK_SYMBOLS &&
+         header.runBytes <= MorseStream::CHUNK_RUN_BYTES &&
+         header.runCount <= header.runBytes &&
+         header.data + symbolBytes + header.runBytes == header.next &&
+         header.next <= indexOffset;
+}
+
+bool MorseStreamReader::loadChunk( const ChunkHeader & header )
+{
+  const unsigned int symbolBytes = ( header.symbolCount + 3 ) / 4;
+
+  if ( !stream.seek( header.data ) ||
+       !stream.read( symbols, symbolBytes ) ||
+       !stream.read( runs, header.runBytes ) )
+  {
+    return false;
+  }
+
+  characterCount = header.firstCharacter;
+  timeCount = header.startTime;
+  symbolCount = header.symbolCount;
+  symbolReadPoint = 0;
+  runCount = header.runCount;
+  runReadPoint = 0;
+  runBytes = header.runBytes;
+  runByteReadPoint = 0;
+  nextChunk = header.next;
+
+  return true;
+}
+
+bool MorseStreamReader::loadNextChunk()
+{
+  ChunkHeader header;
+  return readHeader( nextChunk, header ) && loadChunk( header );
+}
+
+bool MorseStreamReader::readIndexEntry( const unsigned long idx, MorseStream::IndexEntry & entry )
+{
+  unsigned char buffer[ MorseStream::INDEX_ENTRY_LENGTH ];
+
+  if ( !stream.seek( indexOffset + MorseStream::INDEX_HEADER_LENGTH + idx * MorseStream::INDEX_ENTRY_LENGTH ) ||
+       !stream.read( buffer, MorseStream::INDEX_ENTRY_LENGTH ) )
+  {
+    return false;
+  }
+
+  return MorseStream::getU64( buffer, entry.offset ) &&
+         MorseStream::getU64( buffer + 8, entry.firstCharacter ) &&
+         MorseStream::getU64( buffer + 16, entry.startTime );
+}
+
+bool MorseStreamReader::findChunk( const bool byTime, const unsigned long target, ChunkHeader & header )
+{
+  unsigned long offset = firstChunk;
+
+  // Binary search the index for the last indexed chunk starting at or before the target.
+  if ( indexCount > 0 )
+  {
+    MorseStream::IndexEntry entry;
+    unsigned long low = 0;
+    unsigned long high = indexCount;
+
+    while ( high - low > 1 )
+    {
+      const unsigned long middle = low + ( high - low ) / 2;
+      if ( !readIndexEntry( middle, entry ) )
+      {
+        return false;
+      }
+
+      if ( ( byTime ? entry.startTime : entry.firstCharacter ) <= target )
+      {
+        low = middle;
+      }
+      else
+      {
+        high = middle;
+      }
+    }
+
+    if ( !readIndexEntry( low, entry ) )
+    {
+      return false;
+    }
+    if ( ( byTime ? entry.startTime : entry.firstCharacter ) <= target )
+    {
+      offset = entry.offset;
+    }
+  }
+
+  // Step over chunk headers from there. At most stride - 1 of them with an index.
+  if ( !readHeader( offset, header ) )
+  {
+    return false;
+  }
+
+  ChunkHeader next;
+  while ( readHeader( header.next, next ) && ( byTime ? next.startTime : next.firstCharacter ) <= target )
+  {
+    header = next;
+  }
+
+  return true;
+}
+
+MorseStream::Symbol MorseStreamReader::peekSymbol() const
+{
+  return static_cast< MorseStream::Symbol >( ( symbols[ symbolReadPoint / 4 ] >> ( 2 * ( symbolReadPoint % 4 ) ) ) & 0x03 );
+}
@@ -0,0 +1,366 @@
+/*
+  morsestream.h
+
+  Compact binary file format for Morse code element streams and timing runs, with a chunk index for
+  random access by character or by time offset.
+
+  File layout (multi-byte fixed fields are little endian, varints are 7 bits per byte, low bits first):
+
+    Header:   'M' 'O' 'R' 'S' version flags
+    Metadata: { tag varint(length) data[ length ] }... META_END
+    Chunks:   'C' varint(length) varint(firstCharacter) varint(startTime) varint(symbolCount)
+              varint(runCount) varint(runBytes) symbols[ ( symbolCount + 3 ) / 4 ] runs[ runBytes ]
+    Index:    'X' u32(stride) u32(count) { u64(offset) u64(firstCharacter) u64(startTime) }...
+    Trailer:  u64(index offset) 'M' 'I' 'D' 'X'
+
+  Symbols are 2 bits each, four to a byte, first symbol in the low bits. Runs are varint durations in
+  milliseconds, alternating key down and key up, starting with key down. A chunk's length counts every
+  byte after the length field itself, so readers can skip chunks without decoding them. The index holds
+  every stride-th chunk; a writer with a small index buffer doubles the stride when it runs out of room.
+  Positions are written 64 bits wide, so long recordings don't wrap. A reader whose unsigned long is
+  narrower, like the Arduino's, rejects values it can't hold rather than truncating them.
+
+  Version 1 wrote the index and trailer 32 bits wide. Readers only accept the current version.
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#ifndef MORSESTREAM_H
+#define MORSESTREAM_H
+
+#include "morse.h"
+
+class MorseStream
+{
+  public:
+  //
+  // Types
+  //
+
+  // Stream symbols. DOT and DASH share their values with Morse::MorseCodeElement, and the end of a
+  // character shares its value with Morse::SPACE, so codewords copy straight into the stream.
+  enum Symbol { END_OF_CHARACTER = Morse::SPACE, DOT = Morse::DOT, DASH = Morse::DASH, END_OF_WORD = 3 };
+
+  // Metadata record tags.
+  enum MetadataTag { META_END = 0, META_WPM = 1, META_DOT_DURATION = 2, META_SOURCE = 3 };
+
+  // Header flags.
+  enum Flags { FLAG_INDEXED = 0x01 }; // Set when the writer was given index storage.
+
+  // Index entry. Locates the start of a chunk.
+  struct IndexEntry
+  {
+    unsigned long offset;          // File offset of the chunk's tag byte.
+    unsigned long firstCharacter;  // Number of characters before the chunk.
+    unsigned long startTime;       // Sum of run durations before the chunk, in milliseconds.
+  };
+
+  //
+  // Constants
+  //
+
+  static const unsigned char VERSION = 2;
+  static const unsigned char CHUNK_TAG = 'C';
+  static const unsigned char INDEX_TAG = 'X';
+
+  static const unsigned int HEADER_LENGTH = 6;
+  static const unsigned int TRAILER_LENGTH = 12;
+  static const unsigned int INDEX_HEADER_LENGTH = 9;
+  static const unsigned int INDEX_ENTRY_LENGTH = 24;
+
+  // Chunk capacities. Symbols are packed four to a byte.
+  static const unsigned int CHUNK_SYMBOL_BYTES = 64;
+  static const unsigned int CHUNK_SYMBOLS = 4 * CHUNK_SYMBOL_BYTES;
+  static const unsigned int CHUNK_RUN_BYTES = 128;
+
+  // Longest varint needed for a 64-bit value.
+  static const unsigned int VARINT_LENGTH = 10;
+
+  // Longest source description kept by a reader, including the terminator.
+  static const unsigned int SOURCE_LENGTH = 32;
+
+  //
+  // Interface functions
+  //
+
+  // putVarint()
+  // Arguments:
+  //   value - value to encode.
+  //   buffer - storage for at least VARINT_LENGTH bytes.
+  // Returns:
+  //   Number of bytes written to buffer.
+  static unsigned int putVarint( unsigned long value, unsigned char * const buffer );
+
+  // getVarint()
+  // Arguments:
+  //   buffer - encoded bytes.
+  //   length - number of bytes available in buffer.
+  //   value - decoded value.
+  // Returns:
+  //   Number of bytes consumed, or 0 if the varint is truncated, too long, or too big for an unsigned long.
+  static unsigned int getVarint( const unsigned char * const buffer, const unsigned int length, unsigned long & value );
+
+  // putU32() / getU32()
+  // Fixed width little endian 32-bit fields.
+  static void putU32( const unsigned long value, unsigned char * const buffer );
+  static unsigned long getU32( const unsigned char * const buffer );
+
+  // putU64() / getU64()
+  // Fixed width little endian 64-bit fields. getU64() returns false if the value doesn't fit in an
+  // unsigned long.
+  static void putU64( const unsigned long value, unsigned char * const buffer );
+  static bool getU64( const unsigned char * const buffer, unsigned long & value );
+};
+
+// Destination of a stream written by MorseStreamWriter.
+class MorseStreamSink
+{
+  public:
+  virtual ~MorseStreamSink() {}
+
+  // write()
+  // Arguments:
+  //   data - bytes to append.
+  //   length - number of bytes to append.
+  // Returns:
+  //   true if every byte was written.
+  virtual bool write( const unsigned char * const data, const unsigned int length ) = 0;
+};
+
+// Origin of a stream read by MorseStreamReader.
+class MorseStreamSource
+{
+  public:
+  virtual ~MorseStreamSource() {}
+
+  // read()
+  // Returns:
+  //   true if exactly length bytes were read.
+  virtual bool read( unsigned char * const data, const unsigned int length ) = 0;
+
+  // seek()
+  // Returns:
+  //   true if the next read will start at offset.
+  virtual bool seek( const unsigned long offset ) = 0;
+
+  // size()
+  // Returns:
+  //   Total size of the stream in bytes.
+  virtual unsigned long size() = 0;
+};
+
+class MorseStreamWriter
+{
+  public:
+  // Constructor
+  // Arguments:
+  //   sink - where the stream is written.
+  //   index - storage for the chunk index, or 0 to write an unindexed stream.
+  //   indexCapacity - number of entries index can hold.
+  MorseStreamWriter( MorseStreamSink & sink, MorseStream::IndexEntry * const index, const unsigned int indexCapacity );
+
+  // setWpm() / setDotDuration() / setSource()
+  // Optional metadata. Must be called before begin(). source must outlive the call to begin().
+  void setWpm( const unsigned long wpm );
+  void setDotDuration( const unsigned long duration );
+  void setSource( const char * const source );
+
+  // begin()
+  // Writes the header and metadata.
+  bool begin();
+
+  // addCharacter()
+  // Arguments:
+  //   character - ASCII character to encode.
+  // Encoder path. Encodes character with Morse::asciiToMorse() and appends it. ASCII SPACE appends the
+  // end of a word. Characters that cannot be encoded are skipped.
+  bool addCharacter( const char character );
+
+  // addCodeword()
+  // Arguments:
+  //   codeword - Morse::SEQUENCE_LENGTH elements, SPACE terminated if shorter.
+  // Decoder path. Appends a codeword as received.
+  bool addCodeword( const Morse::MorseCodeElement * const codeword );
+
+  // addWordSpace()
+  // Appends the end of a word.
+  bool addWordSpace();
+
+  // addRun()
+  // Arguments:
+  //   duration - milliseconds. Runs alternate key down and key up, starting with key down.
+  // Appends a timing run.
+  bool addRun( const unsigned long duration );
+
+  // finish()
+  // Writes the last chunk, the index, and the trailer.
+  bool finish();
+
+  private:
+  MorseStreamSink &         sink;
+  MorseStream::IndexEntry * index;
+  unsigned int              indexCapacity;
+  unsigned int              indexCount;
+  unsigned long             indexStride;       // Index holds every indexStride-th chunk.
+  unsigned long             chunkCount;
+  unsigned long             offset;            // Bytes written so far.
+  unsigned long             wpm;
+  unsigned long             dotDuration;
+  const char *              source;
+
+  unsigned long             characterCount;    // Characters written, including the current chunk.
+  unsigned long             time;              // Run durations written, including the current chunk.
+  unsigned long             chunkFirstCharacter;
+  unsigned long             chunkStartTime;
+  unsigned int              symbolCount;
+  unsigned int              runCount;
+  unsigned int              runBytes;
+  unsigned char             symbols[ MorseStream::CHUNK_SYMBOL_BYTES ];
+  unsigned char             runs[ MorseStream::CHUNK_RUN_BYTES ];
+
+  // putSymbol()
+  // Appends a symbol to the current chunk. The caller makes room first.
+  void putSymbol( const MorseStream::Symbol symbol );
+
+  // writeMetadata()
+  // Writes one metadata record.
+  bool writeMetadata( const MorseStream::MetadataTag tag, const unsigned char * const data, const unsigned int length );
+
+  // writeVarintMetadata()
+  // Writes one metadata record holding a varint.
+  bool writeVarintMetadata( const MorseStream::MetadataTag tag, const unsigned long value );
+
+  // flushChunk()
+  // Writes the current chunk, if it holds anything, and records it in the index.
+  bool flushChunk();
+
+  // recordChunk()
+  // Adds the chunk at offset to the index, compacting the index if it is full.
+  void recordChunk();
+
+  // emit()
+  // Writes bytes to the sink and tracks the offset.
+  bool emit( const unsigned char * const data, const unsigned int length );
+};
+
+class MorseStreamReader
+{
+  public:
+  // Constructor
+  // Arguments:
+  //   source - where the stream is read from.
+  MorseStreamReader( MorseStreamSource & source );
+
+  // open()
+  // Reads the header, metadata, and index location, and positions the reader at the first chunk.
+  bool open();
+
+  // Metadata. 0 or an empty string if the stream did not record it.
+  unsigned long wpm() const;
+  unsigned long dotDuration() const;
+  const char * source() const;
+
+  // seekCharacter()
+  // Arguments:
+  //   character - number of characters to skip from the start of the stream.
+  // Positions the reader so the next readCharacter() returns the given character. Uses the index
+  // when the stream has one.
+  bool seekCharacter( const unsigned long character );
+
+  // seekTime()
+  // Arguments:
+  //   time - milliseconds from the start of the stream.
+  // Positions the reader so the next readRun() returns the run in progress at the given time.
+  bool seekTime( const unsigned long time );
+
+  // readCodeword()
+  // Arguments:
+  //   codeword - storage for Morse::SEQUENCE_LENGTH elements.
+  //   wordSpace - set if the stream holds the end of a word instead of a codeword.
+  // Decoder path. Returns false at the end of the stream.
+  bool readCodeword( Morse::MorseCodeElement * const codeword, bool & wordSpace );
+
+  // readCharacter()
+  // Returns the next codeword converted with Morse::morseToAscii(), ASCII SPACE at the end of a word,
+  // or 0 at the end of the stream.
+  char readCharacter();
+
+  // readRun()
+  // Arguments:
+  //   duration - milliseconds. Runs alternate key down and key up, starting with key down.
+  // Returns false at the end of the stream. Characters and runs share the loaded chunk, so read a stream
+  // one way at a time: moving on to the next chunk for one discards what is left of the other.
+  bool readRun( unsigned long & duration );
+
+  // character() / time()
+  // Position of the next character or run.
+  unsigned long character() const;
+  unsigned long time() const;
+
+  private:
+  // Chunk header, as read from the stream.
+  struct ChunkHeader
+  {
+    unsigned long offset;
+    unsigned long data;             // Offset of the packed symbols.
+    unsigned long next;             // Offset of the following chunk.
+    unsigned long firstCharacter;
+    unsigned long startTime;
+    unsigned long symbolCount;
+    unsigned long runCount;
+    unsigned long runBytes;
+  };
+
+  MorseStreamSource & stream;
+  unsigned long       wpmValue;
+  unsigned long       dotDurationValue;
+  char                sourceValue[ MorseStream::SOURCE_LENGTH ];
+  unsigned long       firstChunk;       // Offset of the first chunk.
+  unsigned long       indexOffset;      // Offset of the index, or the end of the chunks if unindexed.
+  unsigned long       indexCount;
+  unsigned long       nextChunk;        // Offset of the chunk after the loaded one.
+
+  unsigned long       characterCount;   // Position of the next character.
+  unsigned long       timeCount;        // Position of the next run.
+  unsigned int        symbolCount;
+  unsigned int        symbolReadPoint;
+  unsigned int        runCount;
+  unsigned int        runReadPoint;
+  unsigned int        runBytes;
+  unsigned int        runByteReadPoint;
+  unsigned char       symbols[ MorseStream::CHUNK_SYMBOL_BYTES ];
+  unsigned char       runs[ MorseStream::CHUNK_RUN_BYTES ];
+
+  // readHeader()
+  // Reads the chunk header at offset.
+  bool readHeader( const unsigned long offset, ChunkHeader & header );
+
+  // loadChunk()
+  // Reads the chunk described by header into the chunk buffers.
+  bool loadChunk( const ChunkHeader & header );
+
+  // loadNextChunk()
+  // Reads the chunk following the loaded one.
+  bool loadNextChunk();
+
+  // readIndexEntry()
+  // Reads entry idx of the index.
+  bool readIndexEntry( const unsigned long idx, MorseStream::IndexEntry & entry );
+
+  // findChunk()
+  // Arguments:
+  //   byTime - search by start time instead of first character.
+  //   target - character or time to find.
+  // Reads the header of the last chunk starting at or before target.
+  bool findChunk( const bool byTime, const unsigned long target, ChunkHeader & header );
+
+  // peekSymbol()
+  // Returns the next symbol of the loaded chunk without consuming it.
+  MorseStream::Symbol peekSymbol() const;
+};
+
+#endif
@@ -16,15 +16,36 @@
 MorseToAscii::MorseToAscii() :
   state( IDLE ),
   keypressTimestamp( 0 ),
-  keyInIdx( 0 )
+  keyInIdx( 0 ),
+  output( &serialOutput ),
+  dot( Morse::DOT_DURATION ),
+  letterSpaceThreshold( Morse::LETTER_SPACE_THRESHOLD ),
+  wordSpaceThreshold( Morse::WORD_SPACE_THRESHOLD )
 {
   initializeCodeword();
 }
 
+void MorseToAscii::setOutput( OutputQueue & queue )
+{
+  output = &queue;
+}
+
+void MorseToAscii::setDotDuration( const unsigned long duration )
+{
+  dot = duration;
+  letterSpaceThreshold = Morse::LETTER_SPACE_THRESHOLD * duration / Morse::DOT_DURATION;
+  wordSpaceThreshold = Morse::WORD_SPACE_THRESHOLD * duration / Morse::DOT_DURATION;
+}
+
+unsigned long MorseToAscii::dotDuration() const
+{
+  return dot;
+}
+
 void MorseToAscii::initializeCodeword()
 {
   // Initialize the codeword buffer.
-  for ( unsigned int idx = 0; idx < sizeof( codeword ); ++idx )
+  for ( unsigned int idx = 0; idx < Morse::SEQUENCE_LENGTH; ++idx )
   {
     codeword[ idx ] = Morse::SPACE;
   }
@@ -32,53 +53,53 @@ void MorseToAscii::initializeCodeword()
   keyInIdx = 0;
 }
 
-void MorseToAscii::keypress( const Morse::MorseCodeElement key )
+void MorseToAscii::keypress( const Morse::MorseCodeElement key, const unsigned long & when )
 {
   switch ( state )
   {
     case IDLE:
-      keypressIdle( key );
+      keypressIdle( key, when );
       break;
     case ENCODING:
-      keypressEncoding( key );
+      keypressEncoding( key, when );
       break;
     case EOW_CHECK:
-      keypressEOWCheck( key );
+      keypressEOWCheck( key, when );
       break;
     default:
       // This should never happen. Exceptions aren't supported, so do something more mundane.
-      Serial.println( "\n\n( MTA::keypress() ) ERROR: Unknown state." );
+      serialOutput.println( "\n\n( MTA::keypress() ) ERROR: Unknown state." );
       break;
   }
 }
 
-void MorseToAscii::keypressIdle( const Morse::MorseCodeElement key )
+void MorseToAscii::keypressIdle( const Morse::MorseCodeElement key, const unsigned long & when )
 {
   // Store key in codeword buffer. Timestamp the key.
-  keypressCommon( key );
+  keypressCommon( key, when );
   
   // Change state to ENCODING.
   state = ENCODING;
 }
 
-void MorseToAscii::keypressEncoding( const Morse::MorseCodeElement key )
+void MorseToAscii::keypressEncoding( const Morse::MorseCodeElement key, const unsigned long & when )
 {
   // Store key in codeword buffer. Timestamp the key.
-  keypressCommon( key );
+  keypressCommon( key, when );
   
   // Remain in ENCODING state.
 }
 
-void MorseToAscii::keypressEOWCheck( const Morse::MorseCodeElement key )
+void MorseToAscii::keypressEOWCheck( const Morse::MorseCodeElement key, const unsigned long & when )
 {
   // Store key in codeword buffer. Timestamp the key.
-  keypressCommon( key );
+  keypressCommon( key, when );
   
   // Change state to ENCODING
   state = ENCODING;
 }
 
-void MorseToAscii::keypressCommon( const Morse::MorseCodeElement key )
+void MorseToAscii::keypressCommon( const Morse::MorseCodeElement key, const unsigned long & when )
 {
   // Store key in codeword buffer.
   if ( keyInIdx < Morse::SEQUENCE_LENGTH )
@@ -96,7 +117,7 @@ void MorseToAscii::keypressCommon( const Morse::MorseCodeElement key )
   // else do nothing. We still consider it garbage, so we ignore it until it goes away.
   
   // Timestamp the key. Yes, even if it's garbage.
-  keypressTimestamp = millis();
+  keypressTimestamp = when;
 }
 
 void MorseToAscii::timestamp( const unsigned long & now )
@@ -114,17 +135,17 @@ void MorseToAscii::timestamp( const unsigned long & now )
       break;
     default:
       // This should never happen. Exceptions aren't supported, so do something more mundane.
-      Serial.println( "\n\n( MTA::timestamp() ) ERROR: unknown state." );
+      serialOutput.println( "\n\n( MTA::timestamp() ) ERROR: unknown state." );
       break;
   }
 }
 
 void MorseToAscii::timestampEncoding( const unsigned long & now )
 {
-  if ( now - keypressTimestamp > Morse::LETTER_SPACE_DURATION )
+  if ( now - keypressTimestamp > letterSpaceThreshold )
   {
-    // Convert Morse codeword to ASCII character, and write to serial port.
-    Serial.print( Morse::morseToAscii( codeword ) );
+    // Convert Morse codeword to ASCII character, and queue it for the serial port.
+    output->print( Morse::morseToAscii( codeword ) );
     
     // Reset codeword.
     initializeCodeword();
@@ -136,10 +157,10 @@ void MorseToAscii::timestampEncoding( const unsigned long & now )
 
 void MorseToAscii::timestampEOWCheck( const unsigned long & now )
 {
-  if ( now - keypressTimestamp > Morse::WORD_SPACE_DURATION )
+  if ( now - keypressTimestamp > wordSpaceThreshold )
   {
-    // Write an ASCII SPACE to the serial port.
-    Serial.print( ' ' );
+    // Queue an ASCII SPACE for the serial port.
+    output->print( ' ' );
     
     // Change state to IDLE.
     state = IDLE;
@@ -14,6 +14,7 @@
 #define MORSETOASCII_H
 
 #include "morse.h"
+#include "outputqueue.h"
 
 class MorseToAscii
 {
@@ -21,13 +22,31 @@ class MorseToAscii
   // Constructor
   MorseToAscii();
   
+  // setOutput()
+  // Arguments:
+  //   queue - Where decoded characters are written.
+  // Configures where decoded text goes. Defaults to serialOutput.
+  void setOutput( OutputQueue & queue );
+  
+  // setDotDuration()
+  // Arguments:
+  //   duration - Length of a DOT in milliseconds.
+  // Scales the letter and word space thresholds to a sending speed. Defaults to Morse::DOT_DURATION.
+  void setDotDuration( const unsigned long duration );
+  
+  // dotDuration()
+  // Returns:
+  //   Length of a DOT in milliseconds, as set by setDotDuration(). Pass it to Morse::classifyMark(), so
+  //   keypresses are classified at the same speed as the spaces between them.
+  unsigned long dotDuration() const;
+  
   // keypress()
   // Arguments:
   //   key - DOT or DASH.
   //   when - timestamp in milliseconds of the key.
   // Notify the Morse to ASCII class that a keypress has occurred. This function should be called
-  // when a DOT or DASH has been keyed on the input.
-  void keypress( const Morse::MorseCodeElement key );
+  // when a DOT or DASH has been keyed on the input, with a call to millis() passed in.
+  void keypress( const Morse::MorseCodeElement key, const unsigned long & when );
   
   // timestamp()
   // Arguments:
@@ -45,13 +64,13 @@ class MorseToAscii
   // | IDLE |------------------------------>| ENCODING |
   // +------+                               +----------+
   //    ^                                      ^   |
-  //    |                            keypress: |   | delta_t > LETTER_SPACE_DURATION:
+  //    |                            keypress: |   | delta_t > LETTER_SPACE_THRESHOLD:
   //    |                               store, |   | convert Morse to ASCII, and transmit.
   //    |                            timestamp |   | clear codeword.
   //    |                                      |   V
   //    |                                  +-----------+
   //    +----------------------------------| EOW_CHECK |
-  //       delta_t > WORD_SPACE_DURATION:  +-----------+
+  //       delta_t > WORD_SPACE_THRESHOLD: +-----------+
   //       transmit ASCII SPACE
   //
   enum State { IDLE, ENCODING, EOW_CHECK };
@@ -60,6 +79,10 @@ class MorseToAscii
   unsigned long           keypressTimestamp;                  // Time of last keypress.
   Morse::MorseCodeElement codeword[ Morse::SEQUENCE_LENGTH ]; // Keypress storage.
   unsigned int            keyInIdx;                           // Position in codeword to store received key in.
+  OutputQueue *           output;                             // Decoded text destination.
+  unsigned long           dot;                                // ms
+  unsigned long           letterSpaceThreshold;               // ms
+  unsigned long           wordSpaceThreshold;                 // ms
     
   // initializeCodeword()
   // Prepare the codeword buffer to receive data.
@@ -68,30 +91,34 @@ class MorseToAscii
   // keypressIdle()
   // Arguments:
   //   key - DOT or DASH.
+  //   when - timestamp in milliseconds of the key.
   //
   // Process a keypress in the IDLE state.
-  void keypressIdle( const Morse::MorseCodeElement key );
+  void keypressIdle( const Morse::MorseCodeElement key, const unsigned long & when );
 
   // keypressEncoding()
   // Arguments:
   //   key - DOT or DASH.
+  //   when - timestamp in milliseconds of the key.
   //
   // Process a keypress in the IDLE state.
-  void keypressEncoding( const Morse::MorseCodeElement key );
+  void keypressEncoding( const Morse::MorseCodeElement key, const unsigned long & when );
 
   // keypressEOWCheck()
   // Arguments:
   //   key - DOT or DASH.
+  //   when - timestamp in milliseconds of the key.
   //
   // Process a keypress in the IDLE state.
-  void keypressEOWCheck( const Morse::MorseCodeElement key );
+  void keypressEOWCheck( const Morse::MorseCodeElement key, const unsigned long & when );
   
   // keypressCommon()
   // Arguments:
   //   key - DOT or DASH.
+  //   when - timestamp in milliseconds of the key.
   //
   // Common processing of a keypress to all states.
-  void keypressCommon( const Morse::MorseCodeElement key );
+  void keypressCommon( const Morse::MorseCodeElement key, const unsigned long & when );
   
   // timestampEncoding()
   // Arguments:
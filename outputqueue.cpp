@@ -0,0 +1,147 @@
+/*
+  outputqueue.cpp
+
+  Buffered serial output. Text is appended to a queue in constant time, and written to the serial port
+  only as fast as the UART can take it, so timing-critical code never waits on a transmission.
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <WProgram.h>
+#include <limits.h>
+#include <string.h>
+#include "outputqueue.h"
+
+OutputQueue serialOutput;
+
+OutputQueue::OutputQueue() :
+  queueInsertPoint( 0 ),
+  queueExtractPoint( 0 ),
+  droppedCount( 0 )
+{
+  for ( unsigned int idx = 0; idx < queueSize; ++idx )
+  {
+    queue[ idx ] = 0;
+  }
+}
+
+void OutputQueue::print( const char character )
+{
+  if ( space() == 0 )
+  {
+    ++droppedCount;
+    return;
+  }
+
+  put( character );
+}
+
+void OutputQueue::print( const char * const string )
+{
+  const unsigned int length = strlen( string );
+
+  if ( length > space() )
+  {
+    droppedCount += length;
+    return;
+  }
+
+  for ( const char * character = string; *character != 0; ++character )
+  {
+    put( *character );
+  }
+}
+
+void OutputQueue::print( const unsigned long value, const unsigned int base )
+{
+  // Enough digits for any value in base 2, whatever the width of an unsigned long.
+  char digits[ sizeof( unsigned long ) * CHAR_BIT + 1 ];
+  char * digit = digits + sizeof( digits ) - 1;
+  unsigned long remaining = value;
+  const unsigned int radix = base < 2 || base > 36 ? 10 : base;
+
+  *digit = 0;
+  do
+  {
+    const unsigned int nibble = remaining % radix;
+    *--digit = static_cast< char >( nibble < 10 ? '0' + nibble : 'A' + nibble - 10 );
+    remaining /= radix;
+  } while ( remaining != 0 );
+
+  print( digit );
+}
+
+void OutputQueue::println( const char * const string )
+{
+  const unsigned int length = strlen( string ) + 2;
+
+  if ( length > space() )
+  {
+    droppedCount += length;
+    return;
+  }
+
+  print( string );
+  put( '\r' );
+  put( '\n' );
+}
+
+void OutputQueue::println()
+{
+  println( "" );
+}
+
+bool OutputQueue::pop( char & character )
+{
+  if ( empty() )
+  {
+    return false;
+  }
+
+  character = queue[ queueExtractPoint ];
+  queueExtractPoint = ( queueExtractPoint + 1 ) & ( queueSize - 1 );
+  return true;
+}
+
+void OutputQueue::drain()
+{
+  char character;
+
+  #if defined( UCSR0A )
+  // Only write while the UART's data register is empty. Serial.write() busy-waits on that flag, so
+  // checking it first means the write never blocks.
+  while ( ( UCSR0A & _BV( UDRE0 ) ) && pop( character ) )
+  #else
+  // No UART to wait on.
+  while ( pop( character ) )
+  #endif
+  {
+    Serial.write( character );
+  }
+}
+
+bool OutputQueue::empty() const
+{
+  return queueInsertPoint == queueExtractPoint;
+}
+
+unsigned long OutputQueue::dropped() const
+{
+  return droppedCount;
+}
+
+unsigned int OutputQueue::space() const
+{
+  // One slot stays empty, so a full queue can be told apart from an empty one.
+  return ( queueExtractPoint - queueInsertPoint - 1 ) & ( queueSize - 1 );
+}
+
+void OutputQueue::put( const char character )
+{
+  queue[ queueInsertPoint ] = character;
+  queueInsertPoint = ( queueInsertPoint + 1 ) & ( queueSize - 1 );
+}
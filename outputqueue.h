@@ -0,0 +1,98 @@
+/*
+  outputqueue.h
+
+  Buffered serial output. Text is appended to a queue in constant time, and written to the serial port
+  only as fast as the UART can take it, so timing-critical code never waits on a transmission.
+
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#ifndef OUTPUTQUEUE_H
+#define OUTPUTQUEUE_H
+
+class OutputQueue
+{
+  public:
+  // Constructor
+  OutputQueue();
+
+  // print()
+  // Arguments:
+  //   character - character to queue.
+  // Queues a character. If the queue is full, the character is dropped and counted.
+  void print( const char character );
+
+  // print()
+  // Arguments:
+  //   string - NUL terminated string to queue.
+  // Queues a string. If the whole string does not fit, none of it is queued, and all of it is counted
+  // as dropped. Better to lose a message than to garble the next one.
+  void print( const char * const string );
+
+  // print()
+  // Arguments:
+  //   value - number to queue as text.
+  //   base - numeric base, 2 to 36. Anything else prints in base 10.
+  // Queues a number, all or nothing like strings.
+  void print( const unsigned long value, const unsigned int base );
+
+  // println()
+  // Arguments:
+  //   string - NUL terminated string to queue.
+  // Queues a string followed by a line break, all or nothing.
+  void println( const char * const string );
+
+  // println()
+  // Queues a line break.
+  void println();
+
+  // pop()
+  // Arguments:
+  //   character - storage for the oldest queued character.
+  // Returns:
+  //   true if a character was removed from the queue.
+  bool pop( char & character );
+
+  // drain()
+  // Writes queued characters to the serial port for as long as the UART can accept them without waiting.
+  // Call it from loop() after the timing-critical work is done.
+  void drain();
+
+  // empty()
+  // Returns:
+  //   true if nothing is queued.
+  bool empty() const;
+
+  // dropped()
+  // Returns:
+  //   Number of characters dropped because the queue was full.
+  unsigned long dropped() const;
+
+  private:
+  // Power of two, so the read and write points wrap with a mask.
+  static const unsigned int queueSize = 128;
+
+  char          queue[ queueSize ];
+  unsigned int  queueInsertPoint;
+  unsigned int  queueExtractPoint;
+  unsigned long droppedCount;
+
+  // space()
+  // Returns:
+  //   Number of characters that can be queued.
+  unsigned int space() const;
+
+  // put()
+  // Arguments:
+  //   character - character to queue. The caller has made sure there is room.
+  void put( const char character );
+};
+
+// Queue in front of the serial port, shared by everything that reports over it.
+extern OutputQueue serialOutput;
+
+#endif
@@ -0,0 +1,105 @@
+/*
+  sidetone.cpp
+
+  Audible sidetone for monitoring keying, made by direct digital synthesis.
+    
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/ 
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#include <WProgram.h>
+#include "sidetone.h"
+
+#if defined( TCCR2A ) && defined( TIMSK1 )
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+// One cycle of a sine wave, scaled to -127..127.
+static const unsigned int sineLength = 64;
+static const signed char sineTable[ sineLength ] PROGMEM =
+{
+     0,   12,   25,   37,   49,   60,   71,   81,   90,   98,  106,  112,  117,  122,  125,  126,
+   127,  126,  125,  122,  117,  112,  106,   98,   90,   81,   71,   60,   49,   37,   25,   12,
+     0,  -12,  -25,  -37,  -49,  -60,  -71,  -81,  -90,  -98, -106, -112, -117, -122, -125, -126,
+  -127, -126, -125, -122, -117, -112, -106,  -98,  -90,  -81,  -71,  -60,  -49,  -37,  -25,  -12
+};
+
+// Envelope step per sample, so a ramp from silence to full takes RAMP_DURATION.
+static const unsigned char rampStep = 256 * 1000UL / ( Sidetone::SAMPLE_RATE * Sidetone::RAMP_DURATION );
+
+// Shared with the interrupt. Each is one byte or only written with interrupts off.
+static volatile unsigned int  phaseIncrement = 0;
+static volatile bool          keyDown = false;
+static unsigned int           phase = 0;
+static unsigned char          envelope = 0;
+
+ISR( TIMER1_COMPA_vect )
+{
+  if ( keyDown )
+  {
+    envelope = envelope > 255 - rampStep ? 255 : envelope + rampStep;
+  }
+  else if ( envelope != 0 )
+  {
+    envelope = envelope < rampStep ? 0 : envelope - rampStep;
+  }
+  else
+  {
+    // Silent. Hold the output at the midpoint, and start the next tone at the top of the cycle.
+    OCR2A = 128;
+    phase = 0;
+    return;
+  }
+  
+  phase += phaseIncrement;
+  
+  // Top six bits of the phase index the table.
+  const int sample = static_cast< signed char >( pgm_read_byte( &sineTable[ phase >> 10 ] ) );
+  OCR2A = static_cast< unsigned char >( 128 + ( ( sample * envelope ) >> 8 ) );
+}
+
+void Sidetone::begin( const unsigned int frequency )
+{
+  pinMode( OUTPUT_PIN, OUTPUT );
+  
+  noInterrupts();
+  
+  phaseIncrement = static_cast< unsigned int >( ( static_cast< unsigned long >( frequency ) << 16 ) / SAMPLE_RATE );
+  
+  // Timer2: fast PWM on OC2A, no prescaler, for a 62.5 kHz carrier at 16 MHz.
+  TCCR2A = _BV( COM2A1 ) | _BV( WGM21 ) | _BV( WGM20 );
+  TCCR2B = _BV( CS20 );
+  OCR2A = 128;
+  
+  // Timer1: clear on compare match at the sample rate, no prescaler.
+  TCCR1A = 0;
+  TCCR1B = _BV( WGM12 ) | _BV( CS10 );
+  TCNT1 = 0;
+  OCR1A = F_CPU / SAMPLE_RATE - 1;
+  TIMSK1 = _BV( OCIE1A );
+  
+  interrupts();
+}
+
+void Sidetone::key( const bool down )
+{
+  keyDown = down;
+}
+
+#else
+// No AVR timers to drive. The sidetone is silent.
+
+void Sidetone::begin( const unsigned int frequency )
+{
+  ( void )frequency;
+}
+
+void Sidetone::key( const bool down )
+{
+  ( void )down;
+}
+
+#endif
@@ -0,0 +1,52 @@
+/*
+  sidetone.h
+
+  Audible sidetone for monitoring keying, made by direct digital synthesis. Timer1 interrupts at
+  SAMPLE_RATE. Each interrupt steps a phase accumulator, looks the phase up in a small sine table, scales
+  the sample by an envelope that ramps up on key down and down on key up, and writes it to the duty
+  cycle of Timer2's fast PWM on pin 11. The ramps keep the tone from clicking. The interrupt is a few
+  dozen cycles, about 2% of the CPU, so the keying schedule and input sampling don't notice it.
+
+  Pin 11 needs a low pass filter, a resistor and capacitor will do, before an amplifier or earpiece.
+  Timer2 also drives analogWrite() on pins 3 and 11, and Timer1 on pins 9 and 10, so those can't be used
+  for analogWrite() while the sidetone runs.
+    
+  Written by the MorseCode contributors, October 2026
+  https://github.com/AndrewWasHere/MorseCode
+
+  This code is released under the Creative Commons Attribution 3.0 license
+  To view a copy of this license, visit http://creativecommons.org/licenses/by/3.0/us/ 
+  or send a letter to Creative Commons, 171 Second Street, Suite 300, San Francisco, California, 94105, USA.
+*/
+#ifndef SIDETONE_H
+#define SIDETONE_H
+
+class Sidetone
+{
+  public:
+  //
+  // Constants
+  //
+  
+  static const int           OUTPUT_PIN = 11;    // OC2A
+  static const unsigned long SAMPLE_RATE = 8000; // Hz
+  static const unsigned int  RAMP_DURATION = 5;  // ms, for the envelope to rise or fall.
+  
+  //
+  // Interface functions
+  //
+  
+  // begin()
+  // Arguments:
+  //   frequency - Tone frequency in Hz. Below SAMPLE_RATE / 2.
+  // Sets up the timers and output pin, and starts the interrupt. The tone starts keyed up.
+  static void begin( const unsigned int frequency );
+  
+  // key()
+  // Arguments:
+  //   down - true to sound the tone, false to silence it.
+  // Can be called every time through loop(). The envelope takes care of the transitions.
+  static void key( const bool down );
+};
+
+#endif
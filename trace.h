@@ -17,5 +17,8 @@
 #define TRACE_STATE 0
 #define TRACE_ATM_OUTPUT 0
 
+// Log every edge on the Morse key pin to the serial port, for host/replay. See edgelog.h.
+#define RECORD_EDGES 0
+
 #endif
 